@@ -0,0 +1,163 @@
+#include <benchmark/benchmark.h>
+#include <Rbo/CheckpointStore.hpp>
+#include <Rbo/JsonSerialization.hpp>
+
+using namespace Rbo;
+
+namespace {
+
+namespace fs = std::filesystem;
+
+using Checkpoints = std::vector<std::pair<std::string, GameState>>;
+
+// Checkpoints du fichier JSON donné par RBO_CHECKPOINTS, ou à défaut de parties à 4 joueurs générées
+const Checkpoints& checkpoints() {
+    static const Checkpoints set { []() {
+        Checkpoints set;
+
+        if (const char* const real_set { std::getenv("RBO_CHECKPOINTS") }) {
+            std::ifstream in { real_set };
+            for (const auto& [name, chkpt] : json::parse(in).items())
+                set.push_back({ name, chkpt.get<GameState>() });
+
+            return set;
+        }
+
+        for (word scene { 1 }; scene <= 100; scene++) {
+            GameState state { scene, {}, 1, {} };
+            for (int i { 0 }; i < 5; i++)
+                state.global.insert({ "global" + std::to_string(i), Stat { i * 10, { 0, 1000 }, i == 4, false } });
+
+            for (byte id { 1 }; id <= 4; id++) {
+                PlayerState player { {}, {}, {}, { { "bag", 20 }, { "quests", {} } } };
+                for (int i { 0 }; i < 10; i++) {
+                    player.stats.insert({ "stat" + std::to_string(i), Stat { i, { 0, 100 }, false, i == 0 } });
+                    player.inventories["bag"].insert({ "item" + std::to_string(i), i + 1 });
+                    player.inventories["quests"].insert({ "quest" + std::to_string(i), 1 });
+                }
+
+                state.players.insert({ id, std::move(player) });
+            }
+
+            set.push_back({ "chkpt_" + std::to_string(scene), std::move(state) });
+        }
+
+        return set;
+    }() };
+
+    return set;
+}
+
+// Fichier supprimé à la fin du benchmark
+struct TemporaryFile {
+    const fs::path path;
+
+    explicit TemporaryFile(const std::string& name) : path { fs::temp_directory_path() / name } { fs::remove(path); }
+    ~TemporaryFile() { fs::remove(path); }
+};
+
+CheckpointEncoding encoding(const benchmark::State& state) {
+    return static_cast<CheckpointEncoding>(state.range(0));
+}
+
+void fillStore(CheckpointStore& store) {
+    for (const auto& [name, chkpt] : checkpoints())
+        store.save(name, chkpt);
+}
+
+// Taille moyenne d'un checkpoint dans un journal où chacun n'est écrit qu'une fois, sans enregistrement remplacé ni compactage
+double storeBytesPerCheckpoint(const CheckpointEncoding encoding) {
+    const TemporaryFile file { "rbo-checkpoints-benchmarks-size.rbo" };
+    {
+        CheckpointStore store { file.path, encoding };
+        fillStore(store);
+    }
+
+    return static_cast<double>(fs::file_size(file.path)) / static_cast<double>(checkpoints().size());
+}
+
+void storeSave(benchmark::State& state) {
+    const TemporaryFile file { "rbo-checkpoints-benchmarks.rbo" };
+    CheckpointStore store { file.path, encoding(state) };
+
+    std::size_t i { 0 };
+    for (auto _ : state) {
+        const auto& [name, chkpt] { checkpoints()[i++ % checkpoints().size()] };
+        store.save(name, chkpt);
+    }
+
+    state.counters["bytes_per_checkpoint"] = storeBytesPerCheckpoint(encoding(state));
+}
+
+void storeLoad(benchmark::State& state) {
+    const TemporaryFile file { "rbo-checkpoints-benchmarks.rbo" };
+    CheckpointStore store { file.path, encoding(state) };
+    fillStore(store);
+
+    std::size_t i { 0 };
+    for (auto _ : state)
+        benchmark::DoNotOptimize(store.load(checkpoints()[i++ % checkpoints().size()].first));
+}
+
+void storeOpen(benchmark::State& state) {
+    const TemporaryFile file { "rbo-checkpoints-benchmarks.rbo" };
+    {
+        CheckpointStore store { file.path, encoding(state) };
+        fillStore(store);
+    }
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(CheckpointStore { file.path }.count());
+}
+
+// Référence : tous les checkpoints dans un seul fichier JSON, lu puis réécrit en entier à chaque sauvegarde
+void jsonFileSave(benchmark::State& state) {
+    const TemporaryFile file { "rbo-checkpoints-benchmarks.json" };
+    {
+        json data;
+        for (const auto& [name, chkpt] : checkpoints())
+            data[name] = chkpt;
+
+        std::ofstream { file.path } << data.dump(4);
+    }
+
+    state.counters["bytes_per_checkpoint"] = static_cast<double>(fs::file_size(file.path)) / static_cast<double>(checkpoints().size());
+
+    std::size_t i { 0 };
+    for (auto _ : state) {
+        std::ifstream in { file.path };
+        json data = json::parse(in);
+        in.close();
+
+        const auto& [name, chkpt] { checkpoints()[i++ % checkpoints().size()] };
+        data[name] = chkpt;
+
+        std::ofstream { file.path } << data.dump(4);
+    }
+}
+
+void jsonFileLoad(benchmark::State& state) {
+    const TemporaryFile file { "rbo-checkpoints-benchmarks.json" };
+    {
+        json data;
+        for (const auto& [name, chkpt] : checkpoints())
+            data[name] = chkpt;
+
+        std::ofstream { file.path } << data.dump(4);
+    }
+
+    std::size_t i { 0 };
+    for (auto _ : state) {
+        std::ifstream in { file.path };
+        benchmark::DoNotOptimize(json::parse(in).at(checkpoints()[i++ % checkpoints().size()].first).get<GameState>());
+    }
+}
+
+}
+
+// Arguments : encodage du journal, 0 pour JSON, 1 pour CBOR et 2 pour MessagePack
+BENCHMARK(storeSave)->DenseRange(0, 2);
+BENCHMARK(storeLoad)->DenseRange(0, 2);
+BENCHMARK(storeOpen)->DenseRange(0, 2);
+BENCHMARK(jsonFileSave);
+BENCHMARK(jsonFileLoad);
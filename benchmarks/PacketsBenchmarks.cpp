@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+#include <Rbo/Dictionary.hpp>
+#include <Rbo/Game.hpp>
+#include <Rbo/SessionDataFactory.hpp>
+
+using namespace Rbo;
+
+namespace {
+
+void crash(benchmark::State& state) {
+    for (auto _ : state) {
+        SessionDataFactory factory;
+        factory.makeCrash(3);
+
+        benchmark::DoNotOptimize(factory.dataWithLength());
+    }
+}
+
+void text(benchmark::State& state) {
+    const std::string txt { "Vous entrez dans une taverne sombre et enfumée, le tavernier vous dévisage." };
+
+    for (auto _ : state) {
+        SessionDataFactory factory;
+        factory.makeNormalText(txt);
+
+        benchmark::DoNotOptimize(factory.dataWithLength());
+    }
+}
+
+void options(benchmark::State& state) {
+    const OptionsList choices { "Attaquer", "Fuir", "Parlementer", "Boire une bière" };
+
+    for (auto _ : state) {
+        SessionDataFactory factory;
+        factory.makeOptions(ALL_PLAYERS, "Que faites-vous ?", choices);
+
+        benchmark::DoNotOptimize(factory.dataWithLength());
+    }
+}
+
+void binaryPlayerUpdate(benchmark::State& state) {
+    Game game;
+    PlayerUpdate update;
+
+    for (int i { 0 }; i < state.range(0); i++) {
+        const std::string name { "stat" + std::to_string(i) };
+
+        game.playerStats.insert({ name, {} });
+        update.stats.insert({ name, Stat { i, StatLimits { 0, 100 }, false, i == 0 } });
+    }
+
+    const Dictionary dictionary { game };
+
+    for (auto _ : state) {
+        SessionDataFactory factory;
+        factory.makePlayerUpdate(0, update, dictionary);
+
+        benchmark::DoNotOptimize(factory.dataWithLength());
+    }
+}
+
+}
+
+BENCHMARK(crash);
+BENCHMARK(text);
+BENCHMARK(options);
+BENCHMARK(binaryPlayerUpdate)->Arg(4)->Arg(32);
@@ -8,6 +8,7 @@
 namespace Rbo {
 
 class Data;
+class Packet;
 
 namespace io = boost::asio;
 using ErrCode = boost::system::error_code;
@@ -15,7 +16,8 @@ using tcp = io::ip::tcp;
 using ReceiveBuffer = std::array<byte, 100>;
 
 io::const_buffer trunc(const Data& data);
-ErrCode trySend(tcp::socket& connection, const io::const_buffer& buffer);
+// Ajoute les tampons à écrire pour envoyer le paquet, en omettant ses skipped premiers octets
+void gather(const Packet& packet, std::size_t skipped, std::vector<io::const_buffer>& buffers);
 
 } // namespace Rbo
 
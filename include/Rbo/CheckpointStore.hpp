@@ -0,0 +1,103 @@
+#ifndef CHECKPOINTSTORE_HPP
+#define CHECKPOINTSTORE_HPP
+
+#include <Rbo/Common.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <Rbo/GameBuilder.hpp>
+
+namespace Rbo {
+
+// Encodage des états écrits dans un journal, choisi à sa création
+enum struct CheckpointEncoding : byte {
+    Json, Cbor, MessagePack
+};
+
+struct UnknownCheckpoint : std::logic_error {
+    explicit UnknownCheckpoint(const std::string& name) : std::logic_error { "No checkpoint named \"" + name + '"' } {}
+};
+
+struct CheckpointStoreError : std::runtime_error {
+    CheckpointStoreError(const std::filesystem::path& store, const std::string& msg)
+        : std::runtime_error { "Checkpoint store \"" + store.string() + "\" : " + msg } {}
+};
+
+// Checkpoints écrits à la suite dans un journal jamais réécrit en place, indexés en mémoire par nom à l'ouverture.
+// Une sauvegarde n'ajoute donc que son enregistrement, et un chargement ne lit que celui demandé.
+// Fichier : "RBOC", version du format, encodage des états, puis les enregistrements. Chacun est la longueur de son contenu et le CRC-32
+// de celui-ci (4 octets chacun), suivis du nom du checkpoint (2 octets de longueur) et de son état.
+// Un journal de la version 1, sans encodage et dont les états sont en JSON, reste lisible et passe à la version actuelle au compactage.
+// Un enregistrement incomplet ou corrompu, laissé par une écriture interrompue, est tronqué à l'ouverture avec tous ceux qui le suivent.
+// Une sauvegarde n'est transmise qu'au système, sync() l'écrit sur le disque pour toutes celles faites jusque-là.
+class CheckpointStore {
+private:
+    struct Record {
+        ulong offset;
+        uint length;
+    };
+
+    std::filesystem::path path_;
+    CheckpointEncoding encoding_;
+    // Début du premier enregistrement, après l'en-tête de la version du journal
+    ulong records_begin_;
+    mutable std::mutex file_mtx_;
+    mutable std::fstream file_;
+    std::unordered_map<std::string, Record> index_;
+    // Fin du dernier enregistrement valide, où est écrit le suivant
+    ulong end_;
+    // Octets occupés par des enregistrements remplacés depuis, récupérés au compactage
+    ulong dead_bytes_;
+    // Relevé après un compactage automatique échoué, pour ne le retenter qu'une fois les octets perdus doublés
+    ulong compaction_threshold_;
+
+    // Throw : CheckpointStoreError
+    void readIndex();
+    void writeHeader(std::ostream& out) const;
+    std::string encode(const GameState& state) const;
+    // Throw : json::exception
+    GameState decode(std::string::const_iterator begin, std::string::const_iterator end) const;
+    std::vector<std::pair<const std::string*, Record>> recordsInOrder() const;
+    void open();
+    void compactIfWasteful();
+    void compactLocked();
+
+public:
+    static constexpr std::array<char, 4> MAGIC { 'R', 'B', 'O', 'C' };
+    static constexpr byte FORMAT_VERSION { 2 };
+    static constexpr std::size_t HEADER_SIZE { MAGIC.size() + 2 };
+    static constexpr std::size_t RECORD_HEADER_SIZE { 2 * sizeof(uint) };
+    // Le journal est compacté dès que ses enregistrements remplacés pèsent plus que ce seuil et que ceux encore valides.
+    // Un échec de ce compactage automatique ne fait jamais échouer la sauvegarde qui l'a déclenché.
+    static constexpr ulong COMPACTION_THRESHOLD { 1 << 20 };
+
+    // Crée le journal avec l'encodage donné s'il n'existe pas, sinon garde celui du journal
+    // Throw : CheckpointStoreError
+    explicit CheckpointStore(std::filesystem::path path, const CheckpointEncoding encoding = CheckpointEncoding::Json);
+
+    CheckpointStore(const CheckpointStore&) = delete;
+    CheckpointStore& operator=(const CheckpointStore&) = delete;
+
+    bool contains(const std::string& name) const;
+    std::size_t count() const;
+    // Dans leur ordre d'écriture
+    std::vector<std::string> names() const;
+    CheckpointEncoding encoding() const { return encoding_; }
+    ulong deadBytes() const;
+
+    // Throw : UnknownCheckpoint, CheckpointStoreError
+    GameState load(const std::string& name) const;
+    // Un checkpoint existant du même nom est remplacé
+    // Throw : CheckpointStoreError
+    void save(const std::string& name, const GameState& state);
+    // Throw : CheckpointStoreError
+    void sync();
+    // Réécrit le journal sans les enregistrements remplacés, puis le substitue à l'ancien
+    // Throw : CheckpointStoreError
+    void compact();
+};
+
+} // namespace Rbo
+
+#endif // CHECKPOINTSTORE_HPP
@@ -0,0 +1,58 @@
+#ifndef CHECKPOINTWRITER_HPP
+#define CHECKPOINTWRITER_HPP
+
+#include <Rbo/Common.hpp>
+
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <Rbo/CheckpointStore.hpp>
+
+namespace Rbo {
+
+// Sauvegarde différée des checkpoints : l'état est copié et la main rendue aussitôt, un thread dédié l'ajoute ensuite au journal.
+// Les sauvegardes accumulées pendant une écriture sont ajoutées ensemble puis synchronisées sur le disque une seule fois.
+// Un checkpoint reste lisible depuis la mémoire tant qu'il n'est pas écrit.
+class CheckpointWriter {
+private:
+    struct Pending {
+        std::string name;
+        std::shared_ptr<const GameState> state;
+        std::promise<void> written;
+    };
+
+    const std::shared_ptr<CheckpointStore> store_;
+
+    mutable std::mutex pending_mtx_;
+    std::condition_variable queued_;
+    std::condition_variable written_;
+    std::vector<Pending> queue_;
+    // Dernier état sauvegardé de chaque checkpoint pas encore écrit
+    std::unordered_map<std::string, std::shared_ptr<const GameState>> unwritten_;
+    bool writing_;
+    bool stopping_;
+
+    std::thread worker_;
+
+    void writeQueued();
+
+public:
+    explicit CheckpointWriter(std::shared_ptr<CheckpointStore> store);
+    // Les sauvegardes en attente sont écrites avant l'arrêt du thread
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    bool contains(const std::string& name) const;
+    // Throw : UnknownCheckpoint, CheckpointStoreError
+    GameState load(const std::string& name) const;
+    // Prêt une fois le checkpoint synchronisé sur le disque, ou porteur de l'erreur qui l'en a empêché (CheckpointStoreError, json::exception)
+    std::shared_future<void> save(const std::string& name, GameState state);
+    // Attend l'écriture de toutes les sauvegardes déjà faites
+    void flush();
+};
+
+} // namespace Rbo
+
+#endif // CHECKPOINTWRITER_HPP
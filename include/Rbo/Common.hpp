@@ -10,6 +10,7 @@
 #include <iterator>
 #include <limits>
 #include <map>
+#include <memory>
 #include <numeric>
 #include <optional>
 #include <random>
@@ -17,6 +18,7 @@
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -51,14 +53,32 @@ using RandomEngine = std::mt19937_64;
 
 enum struct ReplyValidity : byte;
 
+// Encodage des paquets de session compris par un client, ceux n'en annonçant aucun reçoivent l'ancien encodage JSON
+enum struct Protocol : byte {
+    Json, Binary
+};
+
+constexpr Protocol LATEST_PROTOCOL { Protocol::Binary };
+
+// Compression des paquets d'un client, qui remet à zéro son flux à chaque compression sélectionnée
+enum struct Compression : byte {
+    None, Deflate
+};
+
+constexpr Compression LATEST_COMPRESSION { Compression::Deflate };
+
 using OptionsList = std::vector<std::string>;
 using Replies = std::unordered_map<byte, byte>;
 using DiceRollResults = std::map<byte, RollResult>; // Triés pour les tests unitaires sur la fabrication de paquets
 using ReplyController = std::function<void(const byte reply)>;
 
+// Jeu chargé, partagé sans copie par toutes les Sessions qui le jouent
+using GamePtr = std::shared_ptr<const Game>;
+
 using Next = std::optional<word>;
 using Instruction = std::function<Next(Gameplay& interface)>;
 using Scene = std::vector<Instruction>;
+using ScenePtr = std::shared_ptr<const Scene>;
 
 using Players = std::map<byte, Player*>;
 using ConstPlayers = std::map<byte, const Player*>;
@@ -243,18 +263,25 @@ std::optional<byte> vote(const Replies& requestResults);
 
 spdlog::logger& rboLogger(std::string name);
 
+// Entiers en big-endian (ordre réseau) sur exactement sizeof(NumType) octets, sans aucune allocation
 template<typename NumType>
-std::vector<byte> decompose(const NumType value) {
-    const NumType byte_mask { 0xff };
-    const std::size_t length { sizeof(NumType) };
+constexpr void writeBigEndian(const NumType value, byte* const output) {
+    static_assert(std::is_integral_v<NumType>);
 
-    std::vector<byte> bytes;
-    bytes.resize(length);
+    const auto bits { static_cast<std::make_unsigned_t<NumType>>(value) };
+    for (std::size_t i { 0 }; i < sizeof(NumType); i++)
+        output[sizeof(NumType) - i - 1] = static_cast<byte>(bits >> (8 * i));
+}
+
+template<typename NumType>
+constexpr NumType readBigEndian(const byte* const input) {
+    static_assert(std::is_integral_v<NumType>);
 
-    for (std::size_t i { 0 }; i < length; i++)
-        bytes[length - i - 1] = (value >> (8 * i)) & byte_mask;
+    std::make_unsigned_t<NumType> bits { 0 };
+    for (std::size_t i { 0 }; i < sizeof(NumType); i++)
+        bits = static_cast<std::make_unsigned_t<NumType>>((bits << 8) | input[i]);
 
-    return bytes;
+    return static_cast<NumType>(bits);
 }
 
 constexpr char ITEM_ENTRY_SEP { '/' };
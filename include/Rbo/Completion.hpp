@@ -0,0 +1,69 @@
+#ifndef COMPLETION_HPP
+#define COMPLETION_HPP
+
+#include <Rbo/AsioCommon.hpp>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <boost/asio/spawn.hpp>
+
+namespace Rbo {
+
+// Taille de la pile de chaque coroutine, les instructions Lua y sont exécutées
+constexpr std::size_t COROUTINE_STACK_SIZE { 1024 * 1024 };
+
+// Coroutine dans laquelle s'exécutent un Lobby et sa Session en mode coroutines, ordonnancée par le strand du Lobby
+struct Coroutine {
+    io::any_io_executor strand;
+    io::yield_context yield;
+};
+
+using OptionalCoroutine = std::optional<Coroutine>;
+
+// Événement signalé par des handlers d'E/S. L'attente bloque le thread appelant, ou suspend la coroutine appelante
+// sans occuper de thread si elle est donnée.
+class Completion {
+private:
+    using Waiter = io::steady_timer;
+
+    std::condition_variable cv_;
+    std::shared_ptr<Waiter> waiter_;
+
+public:
+    Completion() = default;
+
+    Completion(const Completion&) = delete;
+    Completion& operator=(const Completion&) = delete;
+
+    bool operator==(const Completion&) const = delete;
+
+    // Le mutex protégeant l'état attendu doit être verrouillé par l'appelant
+    void notify();
+
+    // Le verrou est relâché pendant l'attente, aucun verrou ne doit être gardé par une coroutine suspendue
+    // car elle peut reprendre sur un autre thread.
+    template<typename Predicate>
+    void wait(std::unique_lock<std::mutex>& lock, Predicate done, const OptionalCoroutine& coroutine = {}) {
+        if (!coroutine) {
+            cv_.wait(lock, done);
+            return;
+        }
+
+        while (!done()) {
+            const std::shared_ptr<Waiter> waiter { std::make_shared<Waiter>(coroutine->strand, Waiter::time_point::max()) };
+            waiter_ = waiter;
+
+            lock.unlock();
+            ErrCode err;
+            waiter->async_wait(coroutine->yield[err]);
+            lock.lock();
+        }
+
+        waiter_.reset();
+    }
+};
+
+} // namespace Rbo
+
+#endif // COMPLETION_HPP
@@ -0,0 +1,44 @@
+#ifndef COMPRESSION_HPP
+#define COMPRESSION_HPP
+
+#include <Rbo/Data.hpp>
+
+struct z_stream_s;
+
+namespace Rbo {
+
+// En deçà, le message est envoyé tel quel, sa compression ne ferait gagner que quelques octets
+constexpr std::size_t MIN_COMPRESSED_LENGTH { 64 };
+
+struct CompressionError : std::runtime_error {
+    explicit CompressionError(const std::string& reason) : std::runtime_error { "Compression error : " + reason } {}
+};
+
+// Flux deflate brut propre à une connexion. Chaque message y est vidé de manière synchrone pour être
+// décompressé dès sa réception, tout en profitant de l'historique des messages précédents.
+// Les octets 00 00 FF FF terminant chaque vidage sont omis, le client les rajoute avant de décompresser.
+class Compressor {
+private:
+    std::unique_ptr<z_stream_s> stream_;
+    std::vector<byte> output_;
+
+public:
+    // Throw : CompressionError
+    Compressor();
+    ~Compressor();
+
+    Compressor(const Compressor&) = delete;
+    Compressor& operator=(const Compressor&) = delete;
+
+    bool operator==(const Compressor&) const = delete;
+
+    // Faux si le message est trop court, ou si sa version compressée pourrait dépasser MAX_CONTENT_LENGTH
+    bool worthCompressing(const Data& message) const;
+    // Contenu du message compressé, précédé de COMPRESSED_EVENT
+    // Throw : CompressionError
+    Packet compress(const Data& message);
+};
+
+} // namespace Rbo
+
+#endif // COMPRESSION_HPP
@@ -0,0 +1,102 @@
+#ifndef CONNECTION_HPP
+#define CONNECTION_HPP
+
+#include <Rbo/AsioCommon.hpp>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <Rbo/Compression.hpp>
+#include <Rbo/Data.hpp>
+
+namespace Rbo {
+
+// Au-delà, le client est considéré trop lent et déconnecté plutôt que de retarder les autres.
+// Un message de taille maximale doit pouvoir attendre avec quelques paquets courts derrière lui.
+constexpr std::size_t MAX_PENDING_BYTES { MAX_CONTENT_LENGTH + 64 * 1024 };
+// Nombre maximal de paquets en file écrits ensemble par un même appel système
+constexpr std::size_t MAX_GATHERED_PACKETS { 64 };
+// Capacité du tampon circulaire de réception, plusieurs messages d'un client peuvent y attendre d'être traités
+constexpr std::size_t RECEIVE_CAPACITY { 512 };
+
+// Les messages des clients ne sont pas préfixés par leur taille, ils sont délimités selon le message attendu
+enum struct FrameType {
+    Byte, String, IdentifiedString
+};
+
+using SendHandler = std::function<void(const ErrCode err, const std::size_t length)>;
+using FrameHandler = std::function<void(const ErrCode err, const ReceiveBuffer& frame, const std::size_t length)>;
+
+// Connexion TCP d'un client dont les paquets sortants sont mis en file, puis écrits de manière asynchrone sur son executor
+class Connection : public std::enable_shared_from_this<Connection> {
+private:
+    struct PendingPacket {
+        Packet packet;
+        SendHandler handler;
+    };
+
+    tcp::socket socket_;
+
+    std::mutex queue_mtx_;
+    std::deque<PendingPacket> queue_;
+    std::size_t pending_bytes_;
+    std::size_t written_;
+    bool writing_;
+    bool held_;
+    bool shutdown_requested_;
+    ErrCode err_;
+    std::unique_ptr<Compressor> compressor_;
+
+    // Une seule réception à la fois, le tampon n'est donc jamais accédé en même temps par plusieurs threads
+    std::array<byte, RECEIVE_CAPACITY> received_;
+    std::size_t received_begin_;
+    std::size_t received_count_;
+    std::atomic<std::size_t> cancellations_;
+
+    void startWriting();
+    void writeNext();
+    void handleWrite(const ErrCode err, const std::size_t length);
+    void fail(const ErrCode err);
+    // Appelle les handlers des paquets en file avec l'erreur de la connexion, le verrou est relâché avant
+    void failQueued(std::unique_lock<std::mutex>& queue_lock);
+
+    byte receivedAt(const std::size_t i) const { return received_[(received_begin_ + i) % RECEIVE_CAPACITY]; }
+    std::optional<std::size_t> bufferedFrame(const FrameType type, bool& oversized) const;
+    void readMore(const FrameType type, const std::size_t generation, FrameHandler handler);
+    void deliverFrame(const FrameType type, const std::size_t generation, const FrameHandler& handler);
+
+public:
+    explicit Connection(tcp::socket socket);
+
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    bool operator==(const Connection&) const = delete;
+
+    tcp::socket& socket() { return socket_; }
+
+    // Retourne une erreur si la connexion a échoué ou si le client ne lit pas assez vite ses paquets, rien n'est alors envoyé.
+    // Le handler est appelé une fois le paquet écrit, ou lorsque la connexion échoue avant.
+    ErrCode send(const Packet& packet, SendHandler handler = {});
+    // Tant qu'elle est retenue, les paquets sont seulement mis en file puis écrits ensemble une fois relâchée
+    void hold(const bool held);
+    // Les paquets envoyés ensuite sont compressés s'ils en valent la peine, dans un nouveau flux propre à cette connexion.
+    // Throw : CompressionError
+    void compress(const Compression compression);
+    // Le handler reçoit le prochain message complet, qui peut déjà avoir été reçu avec les précédents
+    void receive(const FrameType type, FrameHandler handler);
+    // Seules les réceptions sont interrompues, les écritures reprennent là où elles s'étaient arrêtées.
+    // Les messages déjà reçus restent disponibles pour les réceptions suivantes.
+    void cancel();
+    // Oublie les messages reçus mais pas encore lus, à appeler sur l'executor du socket sans réception en cours
+    void discardReceived();
+    // La connexion est fermée une fois tous les paquets en file écrits
+    void shutdown();
+};
+
+using ConnectionPtr = std::shared_ptr<Connection>;
+
+} // namespace Rbo
+
+#endif // CONNECTION_HPP
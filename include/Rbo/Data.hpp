@@ -3,30 +3,71 @@
 
 #include <Rbo/Common.hpp>
 
-namespace Rbo {
+#include <memory>
 
-// Nécessaire pour définir le type DataBuffer. Or, un membre de Data est un DataBuffer, donc MAX_LENGTH doit être définie ici.
-constexpr std::size_t MAX_LENGTH { 1300 };
+namespace Rbo {
 
-using DataBuffer = std::array<byte, MAX_LENGTH>;
+// Taille maximale d'un paquet, limitée par son préfixe de longueur sur 2 octets
+constexpr std::size_t MAX_LENGTH { std::numeric_limits<word>::max() };
+// Taille maximale du contenu d'un message, envoyé en plusieurs fragments s'il ne tient pas dans un seul paquet
+constexpr std::size_t MAX_CONTENT_LENGTH { 1024 * 1024 };
+// Premiers octets d'un fragment et d'un message compressé, distincts de tous les événements du lobby et des sessions
+constexpr byte FRAGMENT_EVENT { 0xFF };
+constexpr byte COMPRESSED_EVENT { 0xFE };
+// Les paquets courts, soit la plupart, tiennent dans le tampon interne et n'allouent rien
+constexpr std::size_t INLINE_DATA_CAPACITY { 128 };
 
 struct BufferOverflow : std::logic_error {
-    BufferOverflow() : std::logic_error { "Overflow : bigger than " + std::to_string(MAX_LENGTH) + " bytes" } {}
+    BufferOverflow() : std::logic_error { "Overflow : content bigger than " + std::to_string(MAX_CONTENT_LENGTH) + " bytes" } {}
+};
+
+struct StringTooLong : std::logic_error {
+    explicit StringTooLong(const std::size_t length)
+        : std::logic_error { "String of " + std::to_string(length) + " bytes, its length prefix is limited to " + std::to_string(MAX_LENGTH) } {}
+};
+
+struct ListTooLong : std::logic_error {
+    explicit ListTooLong(const std::size_t count)
+        : std::logic_error { "List of " + std::to_string(count) + " elements, its count prefix is limited to " + std::to_string(std::numeric_limits<byte>::max()) } {}
+};
+
+struct MalformedData : std::logic_error {
+    explicit MalformedData(const std::string& reason) : std::logic_error { "Malformed data : " + reason } {}
 };
 
+constexpr std::size_t varintSize(ulong value) {
+    std::size_t size { 1 };
+    for (value >>= 7; value != 0; value >>= 7)
+        size++;
+
+    return size;
+}
+
+constexpr ulong zigzag(const std::int64_t value) {
+    return (static_cast<ulong>(value) << 1) ^ static_cast<ulong>(value >> 63);
+}
+
+constexpr std::int64_t unzigzag(const ulong value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+// Tampon d'un paquet, agrandi à la demande. Les octets au-delà de count() ne sont jamais initialisés.
 class Data {
 private:
-    DataBuffer buffer_;
-    std::size_t bytes_ { 0 };
+    std::array<byte, INLINE_DATA_CAPACITY> inline_buffer_;
+    std::unique_ptr<byte[]> heap_buffer_;
+    byte* buffer_;
+    std::size_t capacity_;
+    std::size_t bytes_;
+
+    void take(Data& rhs) noexcept;
 
     template<typename NumType>
     void putNumeric(const NumType value, const std::size_t offset, const bool refresh = true) {
-        if (count() + sizeof(NumType) > MAX_LENGTH)
-            throw BufferOverflow {};
+        if (refresh)
+            reserve(sizeof(NumType));
 
-        std::size_t i { 0 };
-        for (const byte b : decompose(value))
-            buffer_[offset + i++] = b;
+        writeBigEndian(value, buffer_ + offset);
 
         if (refresh)
             bytes_ += sizeof(NumType);
@@ -35,33 +76,114 @@ private:
 public:
     static constexpr std::size_t LENGTH_SIZE { 2 };
     static constexpr std::size_t STR_LENGTH_SIZE { 2 };
+    static constexpr std::size_t MAX_VARINT_SIZE { 10 };
 
     Data();
     explicit Data(const std::vector<byte>& initialData);
 
+    Data(const Data& rhs);
+    Data(Data&& rhs) noexcept;
+    Data& operator=(Data rhs) noexcept;
+
     std::size_t count() const { return bytes_; }
-    const DataBuffer& buffer() const { return buffer_; };
+    std::size_t capacity() const { return capacity_; }
+    const byte* buffer() const { return buffer_; }
 
     bool operator==(const Data& rhs) const;
 
+    // Permet d'écrire ensuite un paquet dont la taille est connue sans autre agrandissement.
+    // Throw : BufferOverflow si le contenu dépasserait MAX_CONTENT_LENGTH
+    void reserve(const std::size_t additional_bytes);
+
     void add(const byte b);
     void add(const bool b);
     template<typename Enum> void add(const Enum e) { add(static_cast<byte>(e)); }
 
+    // Throw : StringTooLong
     void put(const std::string& str);
     template<typename NumType> void putNumeric(const NumType value) { putNumeric(value, count()); }
+    // Throw : ListTooLong, StringTooLong
     void putList(const OptionsList& options);
+    void putBytes(const byte* bytes, const std::size_t length);
+    // 7 bits par octet, poids faibles en premier, le bit de poids fort indiquant qu'un autre octet suit
+    void putVarint(const ulong value);
+    // Entrelacement zigzag pour que les petites valeurs négatives restent elles aussi sur peu d'octets
+    void putSignedVarint(const std::int64_t value);
+
+    // Un message trop long pour son préfixe est fragmenté à l'envoi, le préfixe est alors laissé à 0
+    void refreshLength() { putNumeric<word>(static_cast<word>(count() <= MAX_LENGTH ? count() : 0), 0, false); }
+};
+
+// Lecture d'un paquet à partir du premier octet suivant son préfixe de longueur.
+// Throw : MalformedData si le paquet se termine avant la valeur lue
+class DataReader {
+private:
+    const byte* data_;
+    std::size_t size_;
+    std::size_t position_;
+
+    const byte* take(const std::size_t length);
 
-    void refreshLength() { putNumeric<word>(static_cast<word>(count()), 0, false); }
+public:
+    DataReader(const byte* data, const std::size_t size) : data_ { data }, size_ { size }, position_ { 0 } {}
+    explicit DataReader(const Data& data) : DataReader { data.buffer() + Data::LENGTH_SIZE, data.count() - Data::LENGTH_SIZE } {}
+
+    std::size_t remaining() const { return size_ - position_; }
+
+    byte get() { return *take(1); }
+    bool getBool() { return get() != 0; }
+    template<typename NumType> NumType getNumeric() { return readBigEndian<NumType>(take(sizeof(NumType))); }
+    // Octets bruts suivants, pointant dans le tampon lu
+    const byte* getBytes(const std::size_t length) { return take(length); }
+    std::string getString();
+    OptionsList getList();
+    ulong getVarint();
+    std::int64_t getSignedVarint() { return unzigzag(getVarint()); }
+};
+
+// Paquet immuable prêt à être envoyé, partagé sans copie par les files d'envoi de tous ses destinataires.
+// Un message plus long que MAX_LENGTH est découpé en fragments numérotés que le client concatène dans l'ordre
+// pour retrouver le contenu du message, premier octet compris. Chaque fragment est précédé de son en-tête :
+// longueur sur 2 octets, FRAGMENT_EVENT, numéro du fragment puis nombre de fragments, chacun sur 2 octets.
+class Packet {
+private:
+    std::shared_ptr<const Data> data_;
+    // En-têtes de tous les fragments à la suite, seul le contenu qu'ils précèdent reste dans data_
+    std::shared_ptr<const std::vector<byte>> fragment_headers_;
+    std::size_t count_;
+
+public:
+    static constexpr std::size_t FRAGMENT_HEADER_SIZE { Data::LENGTH_SIZE + 1 + 2 * sizeof(word) };
+    static constexpr std::size_t MAX_FRAGMENT_CONTENT { MAX_LENGTH - FRAGMENT_HEADER_SIZE };
+
+    struct Fragment {
+        const byte* header;
+        const byte* content;
+        std::size_t content_length;
+    };
+
+    explicit Packet(std::shared_ptr<const Data> data);
+
+    const Data& data() const { return *data_; }
+    // Octets écrits sur la connexion, en-têtes des fragments compris
+    std::size_t count() const { return count_; }
+
+    bool fragmented() const { return fragment_headers_ != nullptr; }
+    std::size_t fragments() const { return fragmented() ? fragment_headers_->size() / FRAGMENT_HEADER_SIZE : 1; }
+    // Seulement pour un paquet fragmenté, sinon data() est écrit tel quel
+    Fragment fragment(const std::size_t i) const;
 };
 
 class DataFactory {
 protected:
-    Data data_;
+    std::shared_ptr<Data> data_;
 
 public:
-    const Data& data() const { return data_; }
-    const Data& dataWithLength();
+    DataFactory() : data_ { std::make_shared<Data>() } {}
+
+    const Data& data() const { return *data_; }
+    // Le paquet partage les données de la fabrique, qui ne doit donc plus être modifiée ensuite
+    Packet dataWithLength();
 };
 
 } // namespace Rbo
@@ -0,0 +1,56 @@
+#ifndef DICTIONARY_HPP
+#define DICTIONARY_HPP
+
+#include <Rbo/Common.hpp>
+
+namespace Rbo {
+
+struct UnknownSymbol : std::logic_error {
+    explicit UnknownSymbol(const std::string& name) : std::logic_error { "No ID for symbol \"" + name + "\"" } {}
+};
+
+// Noms d'une même catégorie, identifiés par leur position dans l'ordre alphabétique pour ne pas dépendre du hachage
+class Symbols {
+private:
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, word> ids_;
+
+public:
+    Symbols() = default;
+    explicit Symbols(std::vector<std::string> names);
+
+    word id(const std::string& name) const;
+    const std::vector<std::string>& names() const { return names_; }
+    std::size_t count() const { return names_.size(); }
+};
+
+// Identifiants numériques des noms du jeu, envoyés une fois aux clients binaires pour alléger les paquets suivants
+class Dictionary {
+private:
+    Symbols globals_;
+    Symbols stats_;
+    Symbols inventories_;
+    std::vector<Symbols> items_;
+    Symbols enemies_;
+
+public:
+    Dictionary() = default;
+    explicit Dictionary(const Game& game);
+
+    const Symbols& globals() const { return globals_; }
+    const Symbols& stats() const { return stats_; }
+    const Symbols& inventories() const { return inventories_; }
+    const Symbols& items(const word inventory_id) const { return items_.at(inventory_id); }
+    const Symbols& enemies() const { return enemies_; }
+
+    // Throw : UnknownSymbol
+    word global(const std::string& name) const { return globals_.id(name); }
+    word stat(const std::string& name) const { return stats_.id(name); }
+    word inventory(const std::string& name) const { return inventories_.id(name); }
+    word item(const std::string& inventory_name, const std::string& item_name) const { return items(inventory(inventory_name)).id(item_name); }
+    word enemy(const std::string& generic_name) const { return enemies_.id(generic_name); }
+};
+
+} // namespace Rbo
+
+#endif // DICTIONARY_HPP
@@ -3,6 +3,8 @@
 
 #include <Rbo/Common.hpp>
 
+#include <future>
+
 namespace Rbo {
 
 struct CheckpointLoadingError : std::exception {
@@ -20,14 +22,23 @@ struct GameState {
     PlayersState players;
 };
 
+// Checkpoint dont l'écriture peut se terminer après la sauvegarde, written signalant sa fin ou l'erreur qui l'a empêchée
+struct SavedCheckpoint {
+    std::string name;
+    std::shared_future<void> written;
+};
+
 class GameBuilder {
 public:
     virtual ~GameBuilder() = default;
 
-    virtual Game operator()() const = 0;
+    virtual GamePtr operator()() const = 0;
     virtual GameState load(const std::string& checkpt_final_name) const = 0;
-    virtual std::string save(const std::string& checkpt_name, const GameState& state) const = 0;
-    virtual Scene buildScene(const word id) const = 0;
+    virtual SavedCheckpoint save(const std::string& checkpt_name, const GameState& state) const = 0;
+    // Une scène peut être construite une seule fois, puis rejouée à chaque visite
+    virtual ScenePtr buildScene(const word id) const = 0;
+    // Vrai si les sources du builder ont changé depuis sa construction, il doit alors être reconstruit pour en tenir compte
+    virtual bool outdated() const { return false; }
 };
 
 } // namespace Rbo
@@ -16,6 +16,7 @@ class Gameplay {
 private:
     Session& ctx_;
     std::map<byte, PlayerCache> players_cache_;
+    GroupDescriptor battle_group_;
 
 public:
     explicit Gameplay(Session& ctx) : ctx_ { ctx } {}
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <nlohmann/json.hpp>
 #include <Rbo/Game.hpp>
+#include <Rbo/GameBuilder.hpp>
 
 namespace Rbo { // Doivent être dans le même ns que leur type pour fonctionner avec Json
 
@@ -66,6 +67,9 @@ void from_json(const json& data, PlayerState& player);
 void to_json(json& data, const std::unordered_map<byte, PlayerState>& players);
 void from_json(const json& data, std::unordered_map<byte, PlayerState>& players);
 
+void to_json(json& data, const GameState& state);
+void from_json(const json& data, GameState& state);
+
 void to_json(json& data, const PlayerUpdate& changes);
 
 } // namespace Rbo
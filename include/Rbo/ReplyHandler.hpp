@@ -4,29 +4,36 @@
 #include <Rbo/AsioCommon.hpp>
 
 #include <mutex>
+#include <Rbo/Completion.hpp>
+#include <Rbo/Connection.hpp>
 
 namespace Rbo {
 
 struct InvalidReply;
 
 struct RequestProfile {
-    tcp::socket& connection;
+    ConnectionPtr connection;
     bool isTarget;
 
-    RequestProfile(tcp::socket& c, const bool is_target) : connection { c }, isTarget { is_target } {}
+    RequestProfile(ConnectionPtr c, const bool is_target) : connection { std::move(c) }, isTarget { is_target } {}
 };
 
 struct RequestCtx {
     std::mutex requestMtx;
+    Completion completion;
     std::map<byte, RequestProfile> players;
     byte repliesToAccept;
+    byte repliesToReceive;
 
     Replies replies;
     std::atomic<byte> repliesHandled;
     bool requestDone;
     std::vector<byte> errorIDs;
 
-    RequestCtx() : repliesToAccept { 0 }, repliesHandled { 0 }, requestDone { false } {}
+    RequestCtx() : repliesToAccept { 0 }, repliesToReceive { 0 }, repliesHandled { 0 }, requestDone { false } {}
+
+    // requestMtx doit être verrouillé par l'appelant
+    bool completed() const { return repliesHandled >= repliesToReceive; }
 
     RequestCtx(const RequestCtx&) = delete;
     RequestCtx& operator=(const RequestCtx&) = delete;
@@ -34,13 +41,14 @@ struct RequestCtx {
     bool operator==(const RequestCtx&) = delete;
 };
 
-class ReplyHandler {
+// Les handlers d'E/S partagent le ReplyHandler et son contexte, ils peuvent être appelés après la fin de la requête
+class ReplyHandler : public std::enable_shared_from_this<ReplyHandler> {
 public:
     struct NetworkError : std::runtime_error {
         NetworkError(const std::string& operation, const ErrCode& err) : std::runtime_error { operation + " : " + err.category().name() + (" - " + err.message()) } {}
     };
 
-    ReplyHandler(spdlog::logger& logger, RequestCtx& ctx, const ReplyController controller, const byte p_id);
+    ReplyHandler(spdlog::logger& logger, std::shared_ptr<RequestCtx> ctx, const ReplyController controller, const byte p_id);
 
     ReplyHandler(const ReplyHandler&) = delete;
     ReplyHandler& operator=(const ReplyHandler&) = delete;
@@ -51,7 +59,7 @@ public:
 
 private:
     spdlog::logger& logger_;
-    RequestCtx& ctx_;
+    const std::shared_ptr<RequestCtx> ctx_;
     ReplyController controlValidity;
     byte playerID_;
 
@@ -61,6 +69,7 @@ private:
     void handleReply(const ErrCode error, const std::size_t replyLength);
     ReplyValidity treatReply(const std::size_t replyLength);
 
+    void replyHandled() const;
     void reportError(const byte player_id, const NetworkError& error) const;
     void handleError(const NetworkError& error) const;
 };
@@ -0,0 +1,148 @@
+#ifndef SCHEMA_HPP
+#define SCHEMA_HPP
+
+#include <Rbo/Data.hpp>
+
+#include <tuple>
+
+// Description déclarative des paquets : chaque message est une suite de champs dont découlent
+// sa taille exacte, son encodage (écrit en une seule passe) et son décodage.
+namespace Rbo::Schema {
+
+struct UnexpectedHeader : MalformedData {
+    UnexpectedHeader() : MalformedData { "unexpected message header" } {}
+};
+
+template<typename NumType>
+struct Numeric {
+    using Type = NumType;
+
+    static constexpr std::size_t size(const Type) { return sizeof(Type); }
+    static void encode(Data& data, const Type value) { data.putNumeric(value); }
+    static Type decode(DataReader& reader) { return reader.getNumeric<Type>(); }
+};
+
+using Byte = Numeric<byte>;
+
+template<typename Enum>
+struct Enumeration {
+    using Type = Enum;
+
+    static constexpr std::size_t size(const Type) { return 1; }
+    static void encode(Data& data, const Type value) { data.add(value); }
+    static Type decode(DataReader& reader) { return static_cast<Type>(reader.get()); }
+};
+
+struct Bool {
+    using Type = bool;
+
+    static constexpr std::size_t size(const Type) { return 1; }
+    static void encode(Data& data, const Type value) { data.add(value); }
+    static Type decode(DataReader& reader) { return reader.getBool(); }
+};
+
+struct Varint {
+    using Type = ulong;
+
+    static constexpr std::size_t size(const Type value) { return varintSize(value); }
+    static void encode(Data& data, const Type value) { data.putVarint(value); }
+    static Type decode(DataReader& reader) { return reader.getVarint(); }
+};
+
+struct SignedVarint {
+    using Type = std::int64_t;
+
+    static constexpr std::size_t size(const Type value) { return varintSize(zigzag(value)); }
+    static void encode(Data& data, const Type value) { data.putSignedVarint(value); }
+    static Type decode(DataReader& reader) { return reader.getSignedVarint(); }
+};
+
+struct String {
+    using Type = std::string;
+
+    static std::size_t size(const Type& value) { return Data::STR_LENGTH_SIZE + value.length(); }
+    static void encode(Data& data, const Type& value) { data.put(value); }
+    static Type decode(DataReader& reader) { return reader.getString(); }
+};
+
+// Liste de chaînes précédée de leur nombre sur un octet
+struct Strings {
+    using Type = OptionsList;
+
+    static std::size_t size(const Type& values) {
+        return std::accumulate(values.cbegin(), values.cend(), std::size_t { 1 }, [](const std::size_t total, const std::string& value) {
+            return total + String::size(value);
+        });
+    }
+
+    static void encode(Data& data, const Type& values) { data.putList(values); }
+    static Type decode(DataReader& reader) { return reader.getList(); }
+};
+
+// Liste d'octets précédée de leur nombre sur un octet
+struct Bytes {
+    using Type = std::vector<byte>;
+
+    static std::size_t size(const Type& values) { return 1 + values.size(); }
+
+    static void encode(Data& data, const Type& values) {
+        if (values.size() > std::numeric_limits<byte>::max())
+            throw ListTooLong { values.size() };
+
+        data.add(static_cast<byte>(values.size()));
+        for (const byte value : values)
+            data.add(value);
+    }
+
+    static Type decode(DataReader& reader) {
+        Type values;
+        values.resize(reader.get());
+
+        for (byte& value : values)
+            value = reader.get();
+
+        return values;
+    }
+};
+
+// Octets constants identifiant un message, vérifiés au décodage
+template<auto... Values>
+struct Header {
+    static constexpr std::size_t SIZE { sizeof...(Values) };
+
+    static void encode(Data& data) { (data.add(Values), ...); }
+
+    static void check(DataReader& reader) {
+        const bool expected { ((reader.get() == static_cast<byte>(Values)) && ...) };
+        if (!expected)
+            throw UnexpectedHeader {};
+    }
+};
+
+template<typename MessageHeader, typename... Fields>
+struct Format {
+    using Values = std::tuple<typename Fields::Type...>;
+
+    static constexpr std::size_t size(const typename Fields::Type&... values) {
+        return (MessageHeader::SIZE + ... + Fields::size(values));
+    }
+
+    static void encode(Data& data, const typename Fields::Type&... values) {
+        data.reserve(size(values...));
+
+        MessageHeader::encode(data);
+        (Fields::encode(data, values), ...);
+    }
+
+    // Throw : UnexpectedHeader, MalformedData
+    static Values decode(DataReader& reader) {
+        MessageHeader::check(reader);
+
+        // Les éléments d'une liste entre accolades sont évalués dans l'ordre, les champs sont donc lus dans celui du message
+        return Values { Fields::decode(reader)... };
+    }
+};
+
+} // namespace Rbo::Schema
+
+#endif // SCHEMA_HPP
@@ -16,6 +16,7 @@ struct GameBuildingError : std::runtime_error {
 struct Member {
     std::string name;
     bool ready;
+    Protocol protocol;
 };
 
 using MembersStates = std::map<byte, Member>;
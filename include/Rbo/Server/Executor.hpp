@@ -3,6 +3,9 @@
 
 #include <Rbo/AsioCommon.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <list>
 #include <mutex>
 #include <thread>
 #include <spdlog/logger.h>
@@ -11,22 +14,41 @@
 
 namespace Rbo::Server {
 
+enum struct SessionsMode {
+    Threads, Coroutines
+};
+
 class Executor {
 private:
+    // Délai laissé aux notifications de fermeture des lobbies pour être écrites avant l'arrêt du contexte d'E/S
+    static constexpr std::chrono::milliseconds CLOSING_FLUSH_DELAY { 2000 };
+
     enum State {
         Running, Stopped, EventsLoopError, ServerError
     };
 
+    // Chaque lobby hébergé possède sa propre Session et son propre thread de parties, seul celui-ci accède au lobby
+    struct HostedLobby {
+        Lobby& lobby;
+
+        std::mutex sessionMtx;
+        std::optional<Session> session;
+
+        explicit HostedLobby(Lobby& hosted) : lobby { hosted } {}
+    };
+
     spdlog::logger& logger_;
     io::io_context& server_;
-    std::mutex lobby_mtx_;
-    Lobby& lobby_;
-
-    std::mutex session_mtx_;
-    std::optional<Session> session_;
+    const std::size_t events_threads_;
+    const SessionsMode mode_;
+    std::list<HostedLobby> lobbies_;
+    std::atomic<std::size_t> running_lobbies_;
 
     std::atomic<State> state_;
-    std::atomic_bool stop_handler_done_;
+    std::mutex stop_mtx_;
+    std::condition_variable stop_handler_cv_;
+    bool stop_handler_done_;
+    std::size_t running_events_loops_;
 
     void stop(const State stopped_reason, const std::string_view err_msg = "");
     void runEventsLoop();
@@ -34,71 +56,135 @@ private:
     bool isRunning() { return state_ == Running; }
     bool hasError() { return state_ == EventsLoopError || state_ == ServerError; }
 
-public:
-    Executor(io::io_context& server, Lobby& lobby, spdlog::logger& logger);
-
-    Executor(const Executor&) = delete;
-    Executor& operator=(const Executor&) = delete;
-
-    bool operator==(const Executor&) const = delete;
+    bool hasCoroutines() const { return mode_ == SessionsMode::Coroutines; }
 
     template<typename ExecutorGameBuilder, typename ... BuilderArgs>
-    bool start(BuilderArgs&& ... game_builder_args) {
-        state_ = Running;
-        std::thread events_loop { [this]() { runEventsLoop(); } };
+    void runLobby(HostedLobby& hosted, const OptionalCoroutine& coroutine, const BuilderArgs& ... game_builder_args) {
+        Lobby& lobby { hosted.lobby };
+
+        // Réutilisé par toutes les Sessions du lobby, qui ne se déroulent jamais en même temps et n'accèdent donc
+        // jamais ensemble à son état. Il n'est reconstruit que si ses sources ont été modifiées depuis.
+        std::optional<ExecutorGameBuilder> game_builder;
 
         try {
-            logger_.debug("<-- Running server on this thread.");
-            while (isRunning()) {
-                std::unique_lock lobby_lock { lobby_mtx_, std::defer_lock };
+            logger_.debug("<-- Running lobby on port {} on this {}.", lobby.port(), coroutine ? "coroutine" : "thread");
 
-                lobby_lock.lock();
-                if (lobby_.isIdle())
-                    lobby_.open();
-                lobby_lock.unlock();
+            // Construit dès le démarrage pour rejeter au plus tôt un contenu invalide, puis à nouveau à la préparation s'il a échoué
+            try {
+                game_builder.emplace(game_builder_args...);
+            } catch (const GameBuildingError& err) {
+                logger_.error(err.what());
+            }
 
-                while (lobby_.isOpen() || lobby_.isStarting())
-                    std::this_thread::sleep_for(std::chrono::milliseconds { 1 });
+            while (isRunning()) {
+                if (lobby.isIdle())
+                    lobby.open();
+
+                lobby.waitPreparation(coroutine);
 
                 try {
-                    std::optional<ExecutorGameBuilder> game_builder;
-                    if (lobby_.isPreparing()) {
-                        const std::lock_guard session_lock { session_mtx_ };
+                    if (lobby.isPreparing()) {
+                        const std::lock_guard session_lock { hosted.sessionMtx };
+
+                        if (!game_builder || game_builder->outdated()) {
+                            game_builder.reset();
+                            game_builder.emplace(game_builder_args...);
+                        }
 
-                        game_builder.emplace(std::forward<BuilderArgs>(game_builder_args)...);
-                        session_.emplace(*game_builder);
+                        hosted.session.emplace(*game_builder, coroutine);
                     }
 
-                    lobby_lock.lock();
-                    if (lobby_.isPreparing())
-                        lobby_.prepareSession(*session_);
-                    lobby_lock.unlock();
+                    if (lobby.isPreparing())
+                        lobby.prepareSession(*hosted.session);
 
-                    const std::lock_guard session_lock { session_mtx_ };
-                    session_.reset();
+                    const std::lock_guard session_lock { hosted.sessionMtx };
+                    hosted.session.reset();
                 } catch (const GameBuildingError& err) {
                     logger_.error(err.what());
 
-                    lobby_lock.lock();
-                    if (lobby_.isPreparing()) {
-                        logger_.warn("Game building has failed, reopening lobby...");
-                        lobby_.reset();
+                    if (lobby.isPreparing()) {
+                        logger_.warn("Game building has failed, reopening lobby on port {}...", lobby.port());
+                        lobby.reset();
                     }
-                    lobby_lock.unlock();
 
-                    const std::lock_guard session_lock { session_mtx_ };
-                    session_.reset();
+                    const std::lock_guard session_lock { hosted.sessionMtx };
+                    hosted.session.reset();
                 }
             }
-
-            while (!stop_handler_done_)
-                std::this_thread::sleep_for(std::chrono::milliseconds { 1 });
         } catch (const std::exception& err) {
             stop(ServerError, err.what());
         }
 
+        lobby.close(hasError());
+    }
+
+    // Chaque lobby est exécuté dans une coroutine sur son strand, la dernière à se terminer réveille start()
+    template<typename ExecutorGameBuilder, typename ... BuilderArgs>
+    void spawnLobby(HostedLobby& hosted, const BuilderArgs& ... game_builder_args) {
+        io::spawn(hosted.lobby.strand(), [this, &hosted, &game_builder_args...](io::yield_context yield) {
+            runLobby<ExecutorGameBuilder>(hosted, Coroutine { hosted.lobby.strand(), yield }, game_builder_args...);
+
+            const std::lock_guard stop_lock { stop_mtx_ };
+            if (--running_lobbies_ == 0)
+                stop_handler_cv_.notify_all();
+        }, boost::coroutines::attributes { COROUTINE_STACK_SIZE });
+    }
+
+public:
+    // En mode coroutines, les Sessions attendant les joueurs n'occupent aucun thread
+    Executor(io::io_context& server, std::list<Lobby>& lobbies, spdlog::logger& logger, const std::size_t events_threads = 1, const SessionsMode mode = SessionsMode::Threads);
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    bool operator==(const Executor&) const = delete;
+
+    // Les arguments du GameBuilder sont copiés pour chaque lobby, ils ne peuvent donc pas être transférés
+    template<typename ExecutorGameBuilder, typename ... BuilderArgs>
+    bool start(const BuilderArgs& ... game_builder_args) {
+        state_ = Running;
+        running_events_loops_ = events_threads_;
+
+        // Le contexte d'E/S ne doit s'arrêter qu'une fois les lobbies fermés, même lorsqu'aucune opération n'est en cours
+        io::executor_work_guard<io::io_context::executor_type> events_work { server_.get_executor() };
+
+        std::vector<std::thread> events_loops;
+        for (std::size_t i { 0 }; i < events_threads_; i++)
+            events_loops.emplace_back([this]() { runEventsLoop(); });
+
+        if (hasCoroutines()) {
+            running_lobbies_ = lobbies_.size();
+
+            for (HostedLobby& hosted : lobbies_)
+                spawnLobby<ExecutorGameBuilder>(hosted, game_builder_args...);
+        } else {
+            std::vector<std::thread> lobbies_loops;
+            for (HostedLobby& hosted : lobbies_) {
+                lobbies_loops.emplace_back([this, &hosted, &game_builder_args...]() {
+                    runLobby<ExecutorGameBuilder>(hosted, {}, game_builder_args...);
+                });
+            }
+
+            for (std::thread& lobby_loop : lobbies_loops)
+                lobby_loop.join();
+        }
+
+        std::unique_lock stop_lock { stop_mtx_ };
+        stop_handler_cv_.wait(stop_lock, [this]() { return stop_handler_done_ && running_lobbies_ == 0; });
+
         assert(!isRunning());
-        events_loop.join();
+
+        // Les paquets mis en file par la fermeture des lobbies sont écrits avant que les boucles d'événements ne se terminent d'elles-mêmes
+        events_work.reset();
+        if (!stop_handler_cv_.wait_for(stop_lock, CLOSING_FLUSH_DELAY, [this]() { return running_events_loops_ == 0; })) {
+            logger_.warn("Closing notices not written after {} ms, stopping events loops.", CLOSING_FLUSH_DELAY.count());
+            server_.stop();
+        }
+
+        stop_lock.unlock();
+
+        for (std::thread& events_loop : events_loops)
+            events_loop.join();
 
         return !hasError();
     }
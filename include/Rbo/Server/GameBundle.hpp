@@ -0,0 +1,62 @@
+#ifndef GAMEBUNDLE_HPP
+#define GAMEBUNDLE_HPP
+
+#include <Rbo/Server/Common.hpp>
+
+#include <filesystem>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace Rbo::Server {
+
+namespace fs = std::filesystem;
+
+struct BundleError : std::runtime_error {
+    BundleError(const fs::path& bundle, const std::string& msg)
+        : std::runtime_error { "Invalid game bundle \"" + bundle.string() + "\" : " + msg } {}
+};
+
+// Jeu compilé : ses données en MessagePack et ses scripts précompilés en bytecode Lua, lus sans analyse de texte.
+// Le fichier est projeté en mémoire en lecture seule, ses pages sont donc partagées par les serveurs qui l'ouvrent.
+// Fichier : "RBOB", version du format, nombre de scripts d'instructions, puis le jeu, le script de scènes et ceux d'instructions.
+// Chaque section est le nom de son fichier source (2 octets de longueur) suivi de son contenu (4 octets de longueur).
+class GameBundle {
+public:
+    // Section à écrire dans un bundle
+    struct Source {
+        std::string name;
+        std::string content;
+    };
+
+    // Section lue, pointant dans le fichier projeté tant que le bundle existe
+    struct Section {
+        std::string_view name;
+        std::string_view content;
+    };
+
+private:
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+    Section game_;
+    Section scenes_;
+    // Triés par nom, dans l'ordre où ils sont exécutés
+    std::vector<Section> instructions_;
+
+public:
+    static constexpr std::array<char, 4> MAGIC { 'R', 'B', 'O', 'B' };
+    static constexpr byte FORMAT_VERSION { 2 };
+
+    // Throw : BundleError
+    explicit GameBundle(const fs::path& bundle);
+
+    // Throw : BundleError
+    static void write(const fs::path& bundle, const Source& game, const Source& scenes, std::vector<Source> instructions);
+
+    const Section& game() const { return game_; }
+    const Section& scenes() const { return scenes_; }
+    const std::vector<Section>& instructions() const { return instructions_; }
+};
+
+} // namespace Rbo::Server
+
+#endif // GAMEBUNDLE_HPP
@@ -5,13 +5,16 @@
 
 #include <Rbo/Session.hpp>
 #include <atomic>
+#include <future>
+#include <mutex>
+#include <Rbo/Completion.hpp>
 
 namespace Rbo::Server {
 
 enum struct YesNoQuestion : byte;
 enum struct SessionResult : byte;
 
-using MembersConnection = std::map<byte, tcp::socket>;
+using MembersConnection = std::map<byte, ConnectionPtr>;
 
 struct MasterDisconnected : std::runtime_error {
     explicit MasterDisconnected(const byte id) : std::runtime_error { "Master [" + std::to_string(id) + "] disconnected" } {}
@@ -39,35 +42,46 @@ private:
         Idle, Open, Starting, Preparing, Running, Closed
     };
 
+    static std::size_t counter_;
+
     const std::chrono::milliseconds prepare_delay_;
     const tcp::endpoint acceptor_endpt_;
 
     spdlog::logger& logger_;
+    io::strand<io::io_context::executor_type> strand_;
     tcp::acceptor new_players_acceptor_;
 
     MembersStates members_;
     MembersConnection connections_;
-    RemoteEndptHashmap<tcp::socket> registering_;
-    RemoteEndptHashmap<ReceiveBuffer> registering_buffers_;
-    std::map<byte, ReceiveBuffer> request_buffers_;
+    RemoteEndptHashmap<ConnectionPtr> registering_;
 
+    std::mutex state_mtx_;
+    Completion state_changed_;
     std::atomic_bool closure_requested_;
     std::atomic<State> state_;
     io::steady_timer prepare_timer_;
     Master master_;
+    OptionalCoroutine coroutine_;
+
+    void setState(const State new_state);
+    // Les membres et leurs connexions ne sont modifiés que sur le strand, le thread du lobby y exécute donc ce travail et en attend la fin
+    template<typename Work>
+    void onStrand(Work&& work);
 
     void disconnect(const byte member_id, const bool is_crash = false);
-    void sendToAll(const Data& data);
-    void safeSendToAll(const Data& data);
-    ReceiveBuffer receiveFromMaster();
-    void sendToMaster(const Data& data);
+    void sendToAll(const Packet& data);
+    void safeSendToAll(const Packet& data);
+    ReceiveBuffer receiveFromMaster(const FrameType reply_type);
+    void sendToMaster(const Packet& data);
     void sendMaster();
 
     void acceptMember();
     void listenMember(const byte id);
     void registerMember(const ErrCode err, tcp::socket connection);
-    void handleRegistrationRequest(const tcp::endpoint& client_endpt, const ErrCode& name_err);
-    void handleMemberRequest(const byte member_id, const ErrCode err, const std::size_t request_len);
+    void handleRegistrationRequest(const tcp::endpoint& client_endpt, const ErrCode& name_err, const ReceiveBuffer& id_name_buffer);
+    void handleMemberRequest(const byte member_id, const ErrCode err, const ReceiveBuffer& request_buffer);
+    void handleProtocolRequest(const byte member_id, const ErrCode err, const ReceiveBuffer& version_buffer);
+    void handleCompressionRequest(const byte member_id, const ErrCode err, const ReceiveBuffer& compression_buffer);
     bool updateMaster();
     void disconnectMaster();
     void configureSession(Session& session, const std::optional<std::string>& chkpt_name = {}, std::optional<bool> missing_entrants = {});
@@ -93,8 +107,11 @@ public:
     void reset();
     void prepareSession(Session& session);
     void close(const bool is_crash = false);
-    void requestClosure() { closure_requested_ = true; }
+    void requestClosure();
+    // Bloque (ou suspend la coroutine donnée) jusqu'à ce que le lobby quitte les états Open et Starting, ou jusqu'à une demande de fermeture
+    void waitPreparation(const OptionalCoroutine& coroutine = {});
 
+    const io::strand<io::io_context::executor_type>& strand() const { return strand_; }
     ushort port() const { return acceptor_endpt_.port(); }
     bool registered(const byte id) const { return members().count(id) == 1; }
     bool registered(const std::string& name) const;
@@ -1,6 +1,6 @@
 #include <Rbo/Server/Common.hpp>
 
-#include <Rbo/Data.hpp>
+#include <Rbo/Schema.hpp>
 
 namespace Rbo::Server {
 
@@ -25,7 +25,9 @@ enum struct Event : byte {
     SelectingCheckpoint = 13,
     CheckingPlayers     = 14,
     RevisingParameters  = 15,
-    MasterSwitch        = 16
+    MasterSwitch        = 16,
+    ProtocolSelected    = 17,
+    CompressionSelected = 18
 };
 
 enum struct YesNoQuestion : byte {
@@ -48,6 +50,28 @@ constexpr bool isParametersError(const SessionResult result) {
     return result == SessionResult::CheckpointLoadingError || result == SessionResult::NoPlayerAlive || isInvalidIDs(result);
 }
 
+// Messages du lobby dont la structure est fixe, la liste des membres enregistrés reste écrite par sa fabrique
+namespace LobbySchema {
+
+using namespace Schema;
+
+using Registration = Format<Header<>, Enumeration<RegistrationResult>>;
+using Preparing = Format<Header<Event::BeginCountdown>, Numeric<ulong>>;
+using NewMember = Format<Header<Event::MemberRegistered>, Byte, String>;
+using Ready = Format<Header<Event::MemberReady>, Byte>;
+using Disconnect = Format<Header<Event::MemberDisconnected>, Byte>;
+using Prepare = Format<Header<Event::SessionPreparation>, Byte>;
+using Crash = Format<Header<Event::MemberCrashed>, Byte>;
+using YesNo = Format<Header<Event::AskYesNo>, Enumeration<YesNoQuestion>>;
+using Result = Format<Header<Event::RunResult>, Enumeration<SessionResult>>;
+using InvalidIDs = Format<Header<Event::RunResult>, Enumeration<SessionResult>, Bytes>;
+using NewMaster = Format<Header<Event::MasterSwitch, MasterSwitch::NewMaster>, Byte>;
+using NotAnyMaster = Format<Header<Event::MasterSwitch, MasterSwitch::NotAnyMaster>>;
+using ProtocolSelected = Format<Header<Event::ProtocolSelected>, Enumeration<Protocol>>;
+using CompressionSelected = Format<Header<Event::CompressionSelected>, Enumeration<Compression>>;
+
+} // namespace LobbySchema
+
 struct LobbyDataFactory : DataFactory {
     void makeRegistration(const RegistrationResult result);
     void makeEvent(const Event event);
@@ -62,6 +86,8 @@ struct LobbyDataFactory : DataFactory {
     void makeRegistered(const MembersStates& members);
     void makeInvalidIDs(const SessionResult result, const std::vector<byte>& expected);
     void makeMasterSwitch(const Master& new_master);
+    void makeProtocol(const Protocol protocol);
+    void makeCompression(const Compression compression);
 };
 
 } // namespace Rbo::Server
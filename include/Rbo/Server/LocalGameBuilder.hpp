@@ -3,14 +3,16 @@
 
 #include <Rbo/Server/Common.hpp>
 
+#include <atomic>
 #include <filesystem>
+#include <mutex>
+#include <Rbo/CheckpointWriter.hpp>
 #include <Rbo/GameBuilder.hpp>
 #include <Rbo/Server/InstructionsProvider.hpp>
+#include <Rbo/Server/GameBundle.hpp>
 
 namespace Rbo::Server {
 
-namespace fs = std::filesystem;
-
 struct ScriptLoadingError : GameBuildingError {
     ScriptLoadingError(const fs::path& script, const std::string& msg)
         : GameBuildingError { "Unable to load instructions \"" + script.string() + "\" : " + msg } {}
@@ -20,10 +22,6 @@ struct GameLoadingError : GameBuildingError {
     explicit GameLoadingError(const std::string& msg) : GameBuildingError { "Unable to load game : " + msg } {}
 };
 
-struct GameSavingError : std::runtime_error {
-    explicit GameSavingError(const std::string& msg) : std::runtime_error { "Unable to save game : " + msg } {}
-};
-
 struct SceneLoadingError : std::runtime_error {
     SceneLoadingError(const word id, const std::string& msg) : std::runtime_error { "Unable to load scene " + std::to_string(id) + " : " + msg } {}
 };
@@ -34,18 +32,56 @@ struct CheckpointAlreadyExists : std::logic_error {
 
 class LocalGameBuilder : public GameBuilder {
 private:
-    static std::size_t counter_;
+    // Dernière version lue d'un fichier de jeu, relue seulement si le fichier a été modifié depuis
+    struct LoadedGame {
+        fs::file_time_type last_write;
+        std::size_t hash;
+        GamePtr game;
+    };
+
+    // Date de dernière modification de chaque script exécuté, et du bundle s'il existe
+    using ScriptsVersion = std::map<fs::path, fs::file_time_type>;
+
+    // Les builders de tous les lobbies sont construits en même temps
+    static std::atomic<std::size_t> counter_;
+
+    // Partagés par tous les builders, chaque lobby ayant le sien
+    static std::mutex loaded_games_mtx_;
+    static std::unordered_map<std::string, LoadedGame> loaded_games_;
+    // Un seul index et un seul thread d'écriture par journal, les sauvegardes de tous les lobbies y sont ajoutées à la suite
+    static std::mutex checkpoints_mtx_;
+    static std::unordered_map<std::string, std::shared_ptr<CheckpointWriter>> checkpoints_;
 
     const fs::path game_;
     const fs::path chkpts_;
+    const fs::path scenes_;
+    const fs::path instructions_;
+    const fs::path bundle_;
+    ScriptsVersion scripts_version_;
 
     spdlog::logger& logger_;
+    std::shared_ptr<CheckpointWriter> chkpts_writer_;
     sol::state exec_ctx_;
     sol::table scenes_table_;
     InstructionsProvider provider_;
+    // Toutes les scènes, construites au chargement. Leurs instructions restent liées à l'état Lua de ce builder.
+    std::unordered_map<word, ScenePtr> compiled_scenes_;
+
+    // Throw : CheckpointStoreError
+    std::shared_ptr<CheckpointWriter> openCheckpoints() const;
+    ScriptsVersion scriptsVersion() const;
+    std::optional<GameBundle> openBundle() const;
+    std::optional<GameBundle> upToDateBundle() const;
+    // Throw : SceneLoadingError
+    Scene compileScene(const word id, const sol::object& scene_obj) const;
+    void compileScenes();
 
 public:
-    LocalGameBuilder(fs::path game_file, fs::path checkpts_file, const fs::path& scenes_file, const fs::path& instructions_dir);
+    // Une scène invalide empêche la construction, le contenu erroné est ainsi rejeté avant qu'une partie n'y arrive.
+    // Le jeu et les scripts sont chargés depuis le bundle donné s'il est plus récent que leurs sources, sinon depuis celles-ci.
+    // Un journal de checkpoints encore inexistant est créé, avec ceux du fichier JSON de même nom s'il y en a un.
+    // Throw : GameLoadingError, ScriptLoadingError, CheckpointStoreError
+    LocalGameBuilder(fs::path game_file, fs::path checkpts_file, const fs::path& scenes_file, const fs::path& instructions_dir, fs::path bundle_file = {});
     ~LocalGameBuilder() override = default;
 
     LocalGameBuilder(const LocalGameBuilder&) = delete;
@@ -53,10 +89,16 @@ public:
 
     bool operator==(const LocalGameBuilder&) const = delete;
 
-    Game operator()() const override;
+    // Throw : GameLoadingError
+    GamePtr operator()() const override;
     GameState load(const std::string& checkpt_final_name) const override;
-    std::string save(const std::string& checkpt_generic_name, const GameState& state) const override;
-    Scene buildScene(const word scene_id) const override;
+    // L'état est écrit en arrière-plan, le checkpoint pouvant être chargé dès le retour
+    // Throw : CheckpointAlreadyExists
+    SavedCheckpoint save(const std::string& checkpt_generic_name, const GameState& state) const override;
+    // Throw : SceneLoadingError si aucune scène n'a cet ID
+    ScenePtr buildScene(const word scene_id) const override;
+    // Un script de scènes ou d'instructions, ou le bundle, a été modifié, ajouté ou supprimé
+    bool outdated() const override;
 };
 
 } // namespace Rbo::Server
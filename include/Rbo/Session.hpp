@@ -4,16 +4,21 @@
 #include <Rbo/AsioCommon.hpp>
 
 #include <atomic>
+#include <mutex>
+#include <Rbo/Completion.hpp>
+#include <Rbo/Connection.hpp>
+#include <Rbo/Dictionary.hpp>
 #include <Rbo/Game.hpp>
+#include <Rbo/GameBuilder.hpp>
 #include <Rbo/Player.hpp>
 
 namespace Rbo {
 
-class GameBuilder;
-class Data;
+class Packet;
 class Gameplay;
 
-struct GameState;
+struct RequestCtx;
+struct SessionDataFactory;
 
 enum struct ReplyValidity : byte;
 
@@ -58,10 +63,12 @@ struct IntroductionCheckpoint : std::logic_error {
 
 struct Entrant {
     std::string name;
-    tcp::socket socket;
+    ConnectionPtr connection;
+    Protocol protocol;
 };
 
 using Entrants = std::map<byte, Entrant>;
+using PacketEncoder = std::function<void(SessionDataFactory& factory, const Protocol protocol)>;
 
 // Nécessaire pour conserver les détails des lancés de dés et les envoyés aux joueurs par la suite
 struct DiceRollsDetails {
@@ -72,21 +79,31 @@ struct DiceRollsDetails {
 
 class Session {
 private:
-    static std::size_t counter_;
+    // Chaque lobby crée ses Sessions sur son propre thread ou sa propre coroutine
+    static std::atomic<std::size_t> counter_;
 
     // Variables membres suivant la durée de vie de la Session
     spdlog::logger& logger_;
     const GameBuilder& game_builder_;
-    const Game game_;
+    const GamePtr game_;
+    const Dictionary dictionary_;
     std::atomic_bool running_;
+    const OptionalCoroutine coroutine_;
+
+    // Requête en cours d'attente, à réveiller si la Session est arrêtée
+    std::mutex current_request_mtx_;
+    RequestCtx* current_request_;
 
     // Variables membres suivant la durée de vie d'une partie ( start() )
     DiceRollsDetails rolls_results_;
     StatsManager stats_;
     std::map<byte, Player> players_;
-    std::map<byte, tcp::socket> connections_;
+    std::map<byte, ConnectionPtr> connections_;
+    std::map<byte, Protocol> protocols_;
     std::optional<byte> leader_;
     word current_scene_;
+    bool sends_held_;
+    std::vector<SavedCheckpoint> pending_saves_;
 
     void begin(Entrants& initial_entrants_data);
     void end(Entrants& initial_entrants_data);
@@ -102,14 +119,20 @@ private:
     void playersDiceRolls(Gameplay& interface) const;
 
     Next playScene(Gameplay& interface, const word sceneID);
+    // Les checkpoints sont écrits en arrière-plan, leurs échecs sont signalés aux joueurs dès qu'ils sont connus
+    void reportSaveFailures(const bool wait_all);
+    // Suspend la coroutine jusqu'à la fin des écritures en attente, sans bloquer le thread d'E/S qui l'exécute
+    void waitSavesWritten();
+    void holdSends(const bool held);
 
     void removePlayer(const byte targetID);
 
-    tcp::socket& connection(const byte playerID);
+    Connection& connection(const byte playerID);
     void logPlayerError(const byte playerID, const std::string& msg);
 
 public:
-    explicit Session(const GameBuilder& g_builder);
+    // Avec une coroutine, les requêtes suspendent celle-ci plutôt que de bloquer le thread de la Session
+    explicit Session(const GameBuilder& g_builder, OptionalCoroutine coroutine = {});
 
     Session(const Session&) = delete;
     Session& operator=(const Session&) = delete;
@@ -117,23 +140,28 @@ public:
     bool operator==(const Session&) const = delete;
 
     void start(Entrants& initial_entrants_data, const std::string& final_name = "", const bool missing_entrants = false);
-    void stop() { running_ = false; }
+    void stop();
     bool running() const { return running_; }
     void reset();
 
-    std::string checkpoint(const std::string& generic_name, const word sceneID) const;
+    std::string checkpoint(const std::string& generic_name, const word sceneID);
 
-    const Game& game() const { return game_; }
+    const Game& game() const { return *game_; }
+    const Dictionary& dictionary() const { return dictionary_; }
 
     StatsManager& stats() { return stats_; }
     const StatsManager& stats() const { return stats_; }
 
     const GameBuilder& gameBuilder() const { return game_builder_; }
-
-    Replies request(const byte targets_id, const Data& request_data, ReplyController controller, const bool first_reply_only, const bool wait_all_replies);
-    void sendTo(const byte target, const Data& data);
-    void sendToAll(const Data& data);
-    void sendToAlivePlayers(const Data& data);
+    const OptionalCoroutine& coroutine() const { return coroutine_; }
+
+    Replies request(const byte targets_id, const Packet& request_data, ReplyController controller, const bool first_reply_only, const bool wait_all_replies);
+    void sendTo(const byte target, const Packet& data);
+    void sendToAll(const Packet& data);
+    // Chaque joueur reçoit l'encodage de son protocole, fabriqué une seule fois et seulement si un joueur l'utilise
+    void sendToAll(const PacketEncoder& encode);
+    void sendToAlivePlayers(const Packet& data);
+    Protocol protocol(const byte player_id) const { return protocols_.at(player_id); }
 
     void disconnect(const byte target, const bool is_crash = false);
 
@@ -1,7 +1,7 @@
 #ifndef DATAFACTORY_HPP
 #define DATAFACTORY_HPP
 
-#include <Rbo/Data.hpp>
+#include <Rbo/Schema.hpp>
 
 namespace Rbo {
 
@@ -18,7 +18,8 @@ enum struct Event : byte {
     LeaderSwitch    = 10,
     Start           = 11,
     Stop            = 12,
-    FinishRequest   = 13
+    FinishRequest   = 13,
+    Dictionary      = 14
 };
 
 enum struct Request : byte {
@@ -41,14 +42,55 @@ enum struct Battle : byte {
     Init, Atk, End
 };
 
-constexpr std::size_t OPTIONS_LIMIT { std::numeric_limits<byte>::max() + 1 };
+// Le nombre d'options est préfixé sur un octet
+constexpr std::size_t OPTIONS_LIMIT { std::numeric_limits<byte>::max() };
 
 struct TooManyOptions : std::logic_error {
     explicit TooManyOptions(const std::size_t options_count) : std::logic_error { "There is " + std::to_string(options_count) + " options but the maximum is " + std::to_string(OPTIONS_LIMIT) } {}
 };
 
-class Data;
+// Champs présents dans une mise à jour binaire d'un joueur
+enum struct UpdateField : byte {
+    Death = 1 << 0, Stats = 1 << 1, Items = 1 << 2, Capacities = 1 << 3
+};
+
+// Propriétés d'une statistique dans une mise à jour binaire, les limites par défaut sont omises
+enum struct StatField : byte {
+    Hidden = 1 << 0, Main = 1 << 1, Min = 1 << 2, Max = 1 << 3
+};
+
+// Messages de session dont la structure est fixe, les autres (listes de joueurs, champs optionnels) restent écrits par leur fabrique
+namespace SessionSchema {
+
+using namespace Schema;
+
+using Start = Format<Header<Event::Start>, String>;
+using Stop = Format<Header<Event::Stop>>;
+using Range = Format<Header<Event::Request, Request::Range>, Byte, String, Byte, Byte>;
+using Options = Format<Header<Event::Request, Request::Options>, Byte, String, Strings>;
+using Confirm = Format<Header<Event::Request, Request::Confirm>, Byte>;
+using YesNoQuestion = Format<Header<Event::Request, Request::YesNo>, Byte, String>;
+using NormalText = Format<Header<Event::Text, Text::Normal>, String>;
+using ImportantText = Format<Header<Event::Text, Text::Important>, String>;
+using Title = Format<Header<Event::Text, Text::Title>, String>;
+using Note = Format<Header<Event::Text, Text::Note>, String>;
+using JsonPlayerUpdate = Format<Header<Event::PlayerUpdate>, Byte, String>;
+using Switch = Format<Header<Event::Switch>, Numeric<word>>;
+using Reply = Format<Header<Event::Reply>, Byte, Byte>;
+using Validation = Format<Header<Event::Validation>, Enumeration<ReplyValidity>>;
+using JsonBattleInit = Format<Header<Event::Battle, Battle::Init>, String>;
+using BattleAtk = Format<Header<Event::Battle, Battle::Atk>, Byte, String, Numeric<int>>;
+using BinaryBattleAtk = Format<Header<Event::Battle, Battle::Atk>, Byte, Varint, SignedVarint>;
+using BattleEnd = Format<Header<Event::Battle, Battle::End>>;
+using Crash = Format<Header<Event::Crash>, Byte>;
+using LeaderSwitch = Format<Header<Event::LeaderSwitch>, Byte>;
+
+} // namespace SessionSchema
+
+class Dictionary;
 
+// Les surcharges prenant le dictionnaire (ou le groupe d'ennemis) en plus fabriquent l'encodage binaire, réservé aux clients l'ayant négocié.
+// Les noms y sont remplacés par leur identifiant dans le dictionnaire envoyé au démarrage.
 struct SessionDataFactory : DataFactory {
     void makeEvent(const Event event_type);
     void makeStart(const std::string& game_name);
@@ -62,14 +104,20 @@ struct SessionDataFactory : DataFactory {
     void makeImportantText(const std::string& txt);
     void makeTitle(const std::string& title);
     void makeNote(const std::string& note);
+    void makeDictionary(const Dictionary& dictionary);
     void makePlayerUpdate(const byte id, const PlayerUpdate& changes);
+    void makePlayerUpdate(const byte id, const PlayerUpdate& changes, const Dictionary& dictionary);
     void makeGlobalStat(const std::string& name, const Stat& stat);
+    void makeGlobalStat(const std::string& name, const Stat& stat, const Dictionary& dictionary);
     void makeSwitch(const word scene);
     void makeReply(const byte id, const byte reply);
     void makeValidation(const ReplyValidity validity);
     void makeBattle(const Battle infos);
     void makeBattleInit(const GroupDescriptor& group, const Game& ctx);
+    void makeBattleInit(const GroupDescriptor& group, const Game& ctx, const Dictionary& dictionary);
     void makeBattleAtk(const byte player, const std::string& enemy, const int dmg);
+    // L'ennemi est désigné par sa position dans le groupe annoncé au début du combat
+    void makeBattleAtk(const byte player, const std::string& enemy, const int dmg, const GroupDescriptor& group);
     void makeCrash(const byte id);
     void makeLeaderSwitch(const byte leader);
 };
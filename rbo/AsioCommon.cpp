@@ -8,11 +8,28 @@ io::const_buffer trunc(const Data& data) {
     return io::buffer(data.buffer(), data.count());
 }
 
-ErrCode trySend(tcp::socket& player, const io::const_buffer& buffer) {
-    ErrCode err;
-    player.send(buffer, {}, err);
+void gather(const Packet& packet, std::size_t skipped, std::vector<io::const_buffer>& buffers) {
+    const auto add { [&skipped, &buffers](const io::const_buffer buffer) {
+        if (skipped >= buffer.size()) {
+            skipped -= buffer.size();
+            return;
+        }
 
-    return err;
+        buffers.push_back(buffer + skipped);
+        skipped = 0;
+    } };
+
+    if (!packet.fragmented()) {
+        add(trunc(packet.data()));
+        return;
+    }
+
+    for (std::size_t i { 0 }; i < packet.fragments(); i++) {
+        const Packet::Fragment fragment { packet.fragment(i) };
+
+        add(io::buffer(fragment.header, Packet::FRAGMENT_HEADER_SIZE));
+        add(io::buffer(fragment.content, fragment.content_length));
+    }
 }
 
 } // namespace Rbo
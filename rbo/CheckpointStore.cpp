@@ -0,0 +1,352 @@
+#include <Rbo/CheckpointStore.hpp>
+
+#include <fcntl.h>
+#include <zlib.h>
+#include <spdlog/logger.h>
+#include <Rbo/JsonSerialization.hpp>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Rbo {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+uint checksum(const std::string& payload) {
+    return static_cast<uint>(crc32(0, reinterpret_cast<const Bytef*>(payload.data()), static_cast<uInt>(payload.size())));
+}
+
+// Enregistrement complet, en-tête compris, prêt à être ajouté au journal
+std::string makeRecord(const std::string& name, const std::string& content) {
+    std::string payload(sizeof(word) + name.length(), '\0');
+    writeBigEndian(static_cast<word>(name.length()), reinterpret_cast<byte*>(payload.data()));
+    std::copy(name.cbegin(), name.cend(), payload.begin() + sizeof(word));
+    payload += content;
+
+    std::string record(CheckpointStore::RECORD_HEADER_SIZE, '\0');
+    writeBigEndian(static_cast<uint>(payload.size()), reinterpret_cast<byte*>(record.data()));
+    writeBigEndian(checksum(payload), reinterpret_cast<byte*>(record.data()) + sizeof(uint));
+
+    return record + payload;
+}
+
+// Les flux de la bibliothèque standard ne donnent pas accès à leur descripteur, le fichier est donc rouvert pour être synchronisé
+bool syncFile(const fs::path& file) {
+#ifdef _WIN32
+    const int fd { _wopen(file.c_str(), _O_WRONLY | _O_BINARY) };
+    if (fd == -1)
+        return false;
+
+    const bool synced { _commit(fd) == 0 };
+    _close(fd);
+#else
+    const int fd { ::open(file.c_str(), O_RDONLY) };
+    if (fd == -1)
+        return false;
+
+    const bool synced { ::fsync(fd) == 0 };
+    ::close(fd);
+#endif
+
+    return synced;
+}
+
+word nameLength(const std::string& payload) {
+    return readBigEndian<word>(reinterpret_cast<const byte*>(payload.data()));
+}
+
+// Partagé par tous les journaux, qui n'ont à signaler que leurs compactages échoués
+spdlog::logger& storesLogger() {
+    static spdlog::logger& logger { rboLogger("Checkpoints") };
+    return logger;
+}
+
+}
+
+CheckpointStore::CheckpointStore(fs::path path, const CheckpointEncoding encoding)
+    : path_ { std::move(path) }, encoding_ { encoding }, records_begin_ { HEADER_SIZE }, end_ { 0 }, dead_bytes_ { 0 }, compaction_threshold_ { COMPACTION_THRESHOLD } {
+
+    if (!fs::exists(path_)) {
+        std::ofstream out { path_, std::ios::binary };
+        writeHeader(out);
+
+        if (!out)
+            throw CheckpointStoreError { path_, "unable to create" };
+    }
+
+    readIndex();
+    open();
+    compactIfWasteful();
+}
+
+void CheckpointStore::readIndex() {
+    std::error_code fs_err;
+    const ulong file_size { fs::file_size(path_, fs_err) };
+    if (fs_err)
+        throw CheckpointStoreError { path_, fs_err.message() };
+
+    std::ifstream in { path_, std::ios::binary };
+
+    std::array<char, MAGIC.size() + 1> header;
+    in.read(header.data(), header.size());
+
+    if (!in || !std::equal(MAGIC.cbegin(), MAGIC.cend(), header.cbegin()))
+        throw CheckpointStoreError { path_, "not a checkpoint store" };
+
+    const byte version { static_cast<byte>(header.back()) };
+    if (version == 1) {
+        encoding_ = CheckpointEncoding::Json;
+        records_begin_ = header.size();
+    } else if (version == FORMAT_VERSION) {
+        const byte encoding { static_cast<byte>(in.get()) };
+        if (!in || encoding > static_cast<byte>(CheckpointEncoding::MessagePack))
+            throw CheckpointStoreError { path_, "unknown checkpoints encoding" };
+
+        encoding_ = static_cast<CheckpointEncoding>(encoding);
+        records_begin_ = HEADER_SIZE;
+    } else {
+        throw CheckpointStoreError { path_, "unsupported format version " + std::to_string(version) };
+    }
+
+    end_ = records_begin_;
+
+    std::array<byte, RECORD_HEADER_SIZE> record_header;
+    std::string payload;
+    while (in.read(reinterpret_cast<char*>(record_header.data()), record_header.size())) {
+        const uint length { readBigEndian<uint>(record_header.data()) };
+        // Une longueur corrompue ne doit pas provoquer d'allocation démesurée
+        if (length < sizeof(word) || length > file_size - end_ - RECORD_HEADER_SIZE)
+            break;
+
+        payload.resize(length);
+        in.read(payload.data(), length);
+
+        if (!in || checksum(payload) != readBigEndian<uint>(record_header.data() + sizeof(uint)) || sizeof(word) + nameLength(payload) > length)
+            break;
+
+        const std::string name { payload.substr(sizeof(word), nameLength(payload)) };
+        const auto previous { index_.find(name) };
+        if (previous != index_.cend())
+            dead_bytes_ += RECORD_HEADER_SIZE + previous->second.length;
+
+        index_[name] = { end_, length };
+        end_ += RECORD_HEADER_SIZE + length;
+    }
+
+    in.close();
+    if (end_ < file_size) {
+        fs::resize_file(path_, end_, fs_err);
+
+        if (fs_err)
+            throw CheckpointStoreError { path_, "unable to truncate incomplete records : " + fs_err.message() };
+    }
+}
+
+void CheckpointStore::writeHeader(std::ostream& out) const {
+    out.write(MAGIC.data(), MAGIC.size());
+    out.put(static_cast<char>(FORMAT_VERSION));
+    out.put(static_cast<char>(encoding_));
+}
+
+std::string CheckpointStore::encode(const GameState& state) const {
+    std::string encoded;
+    if (encoding_ == CheckpointEncoding::Cbor)
+        json::to_cbor(json(state), encoded);
+    else if (encoding_ == CheckpointEncoding::MessagePack)
+        json::to_msgpack(json(state), encoded);
+    else
+        encoded = json(state).dump();
+
+    return encoded;
+}
+
+GameState CheckpointStore::decode(const std::string::const_iterator begin, const std::string::const_iterator end) const {
+    if (encoding_ == CheckpointEncoding::Cbor)
+        return json::from_cbor(begin, end).get<GameState>();
+    else if (encoding_ == CheckpointEncoding::MessagePack)
+        return json::from_msgpack(begin, end).get<GameState>();
+    else
+        return json::parse(begin, end).get<GameState>();
+}
+
+std::vector<std::pair<const std::string*, CheckpointStore::Record>> CheckpointStore::recordsInOrder() const {
+    std::vector<std::pair<const std::string*, Record>> records;
+    for (const auto& [name, record] : index_)
+        records.push_back({ &name, record });
+
+    std::sort(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) { return lhs.second.offset < rhs.second.offset; });
+    return records;
+}
+
+void CheckpointStore::open() {
+    file_.open(path_, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file_)
+        throw CheckpointStoreError { path_, "unable to open" };
+}
+
+bool CheckpointStore::contains(const std::string& name) const {
+    const std::lock_guard file_lock { file_mtx_ };
+    return index_.count(name) == 1;
+}
+
+std::size_t CheckpointStore::count() const {
+    const std::lock_guard file_lock { file_mtx_ };
+    return index_.size();
+}
+
+std::vector<std::string> CheckpointStore::names() const {
+    const std::lock_guard file_lock { file_mtx_ };
+
+    std::vector<std::string> names;
+    for (const auto& record : recordsInOrder())
+        names.push_back(*record.first);
+
+    return names;
+}
+
+ulong CheckpointStore::deadBytes() const {
+    const std::lock_guard file_lock { file_mtx_ };
+    return dead_bytes_;
+}
+
+GameState CheckpointStore::load(const std::string& name) const {
+    const std::lock_guard file_lock { file_mtx_ };
+
+    const auto record { index_.find(name) };
+    if (record == index_.cend())
+        throw UnknownCheckpoint { name };
+
+    std::string payload(record->second.length, '\0');
+    file_.seekg(static_cast<std::streamoff>(record->second.offset + RECORD_HEADER_SIZE));
+    file_.read(payload.data(), static_cast<std::streamsize>(payload.size()));
+
+    if (!file_) {
+        file_.clear();
+        throw CheckpointStoreError { path_, "unable to read \"" + name + '"' };
+    }
+
+    try {
+        return decode(payload.cbegin() + sizeof(word) + nameLength(payload), payload.cend());
+    } catch (const json::exception& err) {
+        throw CheckpointStoreError { path_, "invalid checkpoint \"" + name + "\" : " + err.what() };
+    }
+}
+
+void CheckpointStore::save(const std::string& name, const GameState& state) {
+    if (name.length() > std::numeric_limits<word>::max())
+        throw CheckpointStoreError { path_, "checkpoint name too long" };
+
+    const std::string record { makeRecord(name, encode(state)) };
+    const uint length { static_cast<uint>(record.size() - RECORD_HEADER_SIZE) };
+
+    const std::lock_guard file_lock { file_mtx_ };
+
+    // Un ajout interrompu est recouvert par le suivant, le journal n'avance qu'une fois l'enregistrement écrit
+    file_.seekp(static_cast<std::streamoff>(end_));
+    file_.write(record.data(), static_cast<std::streamsize>(record.size()));
+    file_.flush();
+
+    if (!file_) {
+        file_.clear();
+        throw CheckpointStoreError { path_, "unable to append \"" + name + '"' };
+    }
+
+    const auto previous { index_.find(name) };
+    if (previous != index_.cend())
+        dead_bytes_ += RECORD_HEADER_SIZE + previous->second.length;
+
+    index_[name] = { end_, length };
+    end_ += record.size();
+
+    compactIfWasteful();
+}
+
+void CheckpointStore::sync() {
+    const std::lock_guard file_lock { file_mtx_ };
+
+    if (!syncFile(path_))
+        throw CheckpointStoreError { path_, "unable to sync on disk" };
+}
+
+void CheckpointStore::compact() {
+    const std::lock_guard file_lock { file_mtx_ };
+    compactLocked();
+}
+
+void CheckpointStore::compactIfWasteful() {
+    const ulong live_bytes { end_ - records_begin_ - dead_bytes_ };
+    if (dead_bytes_ <= compaction_threshold_ || dead_bytes_ <= live_bytes)
+        return;
+
+    try {
+        compactLocked();
+    } catch (const CheckpointStoreError& err) {
+        compaction_threshold_ = 2 * dead_bytes_;
+        storesLogger().warn("{}, retrying beyond {} dead bytes.", err.what(), compaction_threshold_);
+
+        return;
+    }
+
+    compaction_threshold_ = COMPACTION_THRESHOLD;
+}
+
+void CheckpointStore::compactLocked() {
+    const fs::path compacted { path_.string() + ".tmp" };
+
+    // Enregistrements recopiés dans leur ordre d'écriture
+    const std::vector<std::pair<const std::string*, Record>> records { recordsInOrder() };
+
+    std::unordered_map<std::string, Record> index;
+    ulong end { HEADER_SIZE };
+    {
+        std::ofstream out { compacted, std::ios::binary | std::ios::trunc };
+        writeHeader(out);
+
+        std::string record;
+        for (const auto& [name, location] : records) {
+            record.resize(RECORD_HEADER_SIZE + location.length);
+            file_.seekg(static_cast<std::streamoff>(location.offset));
+            file_.read(record.data(), static_cast<std::streamsize>(record.size()));
+            out.write(record.data(), static_cast<std::streamsize>(record.size()));
+
+            index.insert({ *name, { end, location.length } });
+            end += record.size();
+        }
+
+        out.close();
+        if (!file_ || !out || !syncFile(compacted)) {
+            file_.clear();
+
+            std::error_code ignored;
+            fs::remove(compacted, ignored);
+
+            throw CheckpointStoreError { path_, "unable to compact" };
+        }
+    }
+
+    file_.close();
+
+    std::error_code fs_err;
+    fs::rename(compacted, path_, fs_err);
+    if (fs_err) {
+        std::error_code ignored;
+        fs::remove(compacted, ignored);
+        open();
+
+        throw CheckpointStoreError { path_, "unable to replace with compacted store : " + fs_err.message() };
+    }
+
+    index_ = std::move(index);
+    records_begin_ = HEADER_SIZE;
+    end_ = end;
+    dead_bytes_ = 0;
+
+    open();
+}
+
+} // namespace Rbo
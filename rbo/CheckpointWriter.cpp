@@ -0,0 +1,113 @@
+#include <Rbo/CheckpointWriter.hpp>
+
+namespace Rbo {
+
+CheckpointWriter::CheckpointWriter(std::shared_ptr<CheckpointStore> store)
+    : store_ { std::move(store) }, writing_ { false }, stopping_ { false }, worker_ { [this]() { writeQueued(); } } {}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        const std::lock_guard pending_lock { pending_mtx_ };
+        stopping_ = true;
+    }
+
+    queued_.notify_one();
+    worker_.join();
+}
+
+bool CheckpointWriter::contains(const std::string& name) const {
+    {
+        const std::lock_guard pending_lock { pending_mtx_ };
+        if (unwritten_.count(name) == 1)
+            return true;
+    }
+
+    return store_->contains(name);
+}
+
+GameState CheckpointWriter::load(const std::string& name) const {
+    {
+        const std::lock_guard pending_lock { pending_mtx_ };
+
+        const auto unwritten { unwritten_.find(name) };
+        if (unwritten != unwritten_.cend())
+            return *unwritten->second;
+    }
+
+    return store_->load(name);
+}
+
+std::shared_future<void> CheckpointWriter::save(const std::string& name, GameState state) {
+    Pending pending { name, std::make_shared<const GameState>(std::move(state)), {} };
+    std::shared_future<void> written { pending.written.get_future().share() };
+
+    {
+        const std::lock_guard pending_lock { pending_mtx_ };
+
+        unwritten_[name] = pending.state;
+        queue_.push_back(std::move(pending));
+    }
+
+    queued_.notify_one();
+    return written;
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock pending_lock { pending_mtx_ };
+    written_.wait(pending_lock, [this]() { return queue_.empty() && !writing_; });
+}
+
+void CheckpointWriter::writeQueued() {
+    std::unique_lock pending_lock { pending_mtx_ };
+
+    while (true) {
+        queued_.wait(pending_lock, [this]() { return stopping_ || !queue_.empty(); });
+        if (queue_.empty())
+            return;
+
+        std::vector<Pending> batch;
+        batch.swap(queue_);
+        writing_ = true;
+
+        pending_lock.unlock();
+
+        std::vector<std::exception_ptr> errors(batch.size());
+        for (std::size_t i { 0 }; i < batch.size(); i++) {
+            try {
+                store_->save(batch[i].name, *batch[i].state);
+            } catch (const std::exception&) {
+                errors[i] = std::current_exception();
+            }
+        }
+
+        try {
+            store_->sync();
+        } catch (const std::exception&) {
+            for (std::exception_ptr& error : errors) {
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+
+        pending_lock.lock();
+
+        // Un checkpoint sauvegardé à nouveau entre-temps garde son dernier état, qui reste à écrire
+        for (const Pending& written : batch) {
+            const auto unwritten { unwritten_.find(written.name) };
+            if (unwritten->second == written.state)
+                unwritten_.erase(unwritten);
+        }
+
+        writing_ = false;
+        written_.notify_all();
+
+        for (std::size_t i { 0 }; i < batch.size(); i++) {
+            if (errors[i])
+                batch[i].written.set_exception(errors[i]);
+            else
+                batch[i].written.set_value();
+        }
+    }
+}
+
+} // namespace Rbo
@@ -0,0 +1,16 @@
+#include <Rbo/Completion.hpp>
+
+namespace Rbo {
+
+void Completion::notify() {
+    cv_.notify_all();
+
+    // L'annulation passe par le strand de la coroutine : elle ne peut donc être traitée qu'une fois la coroutine suspendue
+    if (waiter_) {
+        io::post(waiter_->get_executor(), [waiter = waiter_]() {
+            waiter->cancel();
+        });
+    }
+}
+
+} // namespace Rbo
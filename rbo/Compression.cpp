@@ -0,0 +1,69 @@
+#include <Rbo/Compression.hpp>
+
+#define ZLIB_CONST
+#include <zlib.h>
+
+namespace Rbo {
+
+namespace {
+
+// Fin d'un vidage synchrone, omise de chaque message
+constexpr std::array<byte, 4> SYNC_FLUSH_TAIL { 0x00, 0x00, 0xFF, 0xFF };
+// deflateBound() ne compte pas le bloc vide ajouté par le vidage synchrone
+constexpr std::size_t SYNC_FLUSH_MARGIN { 16 };
+
+std::string zlibError(const z_stream_s& stream, const int code) {
+    return stream.msg ? stream.msg : "zlib code " + std::to_string(code);
+}
+
+}
+
+Compressor::Compressor() : stream_ { std::make_unique<z_stream_s>() } {
+    // Flux brut, sans en-tête ni somme de contrôle zlib, la connexion TCP assurant déjà l'intégrité
+    const int init_result { deflateInit2(stream_.get(), Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) };
+    if (init_result != Z_OK)
+        throw CompressionError { zlibError(*stream_, init_result) };
+}
+
+Compressor::~Compressor() {
+    deflateEnd(stream_.get());
+}
+
+bool Compressor::worthCompressing(const Data& message) const {
+    const std::size_t content_length { message.count() - Data::LENGTH_SIZE };
+    if (content_length < MIN_COMPRESSED_LENGTH)
+        return false;
+
+    return 1 + deflateBound(stream_.get(), content_length) + SYNC_FLUSH_MARGIN <= MAX_CONTENT_LENGTH;
+}
+
+Packet Compressor::compress(const Data& message) {
+    assert(worthCompressing(message));
+
+    const std::size_t content_length { message.count() - Data::LENGTH_SIZE };
+    output_.resize(deflateBound(stream_.get(), content_length) + SYNC_FLUSH_MARGIN);
+
+    stream_->next_in = message.buffer() + Data::LENGTH_SIZE;
+    stream_->avail_in = static_cast<uInt>(content_length);
+    stream_->next_out = output_.data();
+    stream_->avail_out = static_cast<uInt>(output_.size());
+
+    const int deflate_result { deflate(stream_.get(), Z_SYNC_FLUSH) };
+    if (deflate_result != Z_OK || stream_->avail_in != 0 || stream_->avail_out == 0)
+        throw CompressionError { zlibError(*stream_, deflate_result) };
+
+    const std::size_t produced { output_.size() - stream_->avail_out };
+    assert(std::equal(SYNC_FLUSH_TAIL.cbegin(), SYNC_FLUSH_TAIL.cend(), output_.cbegin() + produced - SYNC_FLUSH_TAIL.size()));
+
+    const std::size_t compressed_length { produced - SYNC_FLUSH_TAIL.size() };
+
+    auto compressed { std::make_shared<Data>() };
+    compressed->reserve(1 + compressed_length);
+    compressed->add(COMPRESSED_EVENT);
+    compressed->putBytes(output_.data(), compressed_length);
+    compressed->refreshLength();
+
+    return Packet { std::move(compressed) };
+}
+
+} // namespace Rbo
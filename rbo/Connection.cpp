@@ -0,0 +1,281 @@
+#include <Rbo/Connection.hpp>
+
+#include <Rbo/Data.hpp>
+
+namespace Rbo {
+
+Connection::Connection(tcp::socket socket)
+    : socket_ { std::move(socket) },
+      pending_bytes_ { 0 },
+      written_ { 0 },
+      writing_ { false },
+      held_ { false },
+      shutdown_requested_ { false },
+      received_ {},
+      received_begin_ { 0 },
+      received_count_ { 0 },
+      cancellations_ { 0 } {}
+
+// queue_mtx_ doit être verrouillé par l'appelant
+void Connection::startWriting() {
+    if (writing_)
+        return;
+
+    writing_ = true;
+    io::post(socket_.get_executor(), [self { shared_from_this() }]() { self->writeNext(); });
+}
+
+// queue_mtx_ doit être verrouillé par l'appelant
+void Connection::fail(const ErrCode err) {
+    err_ = err;
+
+    // Interrompt l'écriture en cours, dont le handler videra alors la file. Sans écriture en cours,
+    // notamment lorsque la connexion est retenue, la suivante la vide aussitôt.
+    startWriting();
+
+    io::post(socket_.get_executor(), [self { shared_from_this() }]() {
+        ErrCode close_err;
+        self->socket_.close(close_err);
+    });
+}
+
+ErrCode Connection::send(const Packet& packet, SendHandler handler) {
+    const std::lock_guard queue_lock { queue_mtx_ };
+    if (err_)
+        return err_;
+
+    // Compressé sous le verrou, les paquets passent par le flux dans l'ordre où le client les recevra
+    const bool compressed { compressor_ && compressor_->worthCompressing(packet.data()) };
+    Packet queued { compressed ? compressor_->compress(packet.data()) : packet };
+
+    if (pending_bytes_ + queued.count() > MAX_PENDING_BYTES) {
+        fail(io::error::basic_errors::no_buffer_space);
+        return err_;
+    }
+
+    pending_bytes_ += queued.count();
+    queue_.push_back({ std::move(queued), std::move(handler) });
+
+    if (!held_)
+        startWriting();
+
+    return {};
+}
+
+void Connection::hold(const bool held) {
+    const std::lock_guard queue_lock { queue_mtx_ };
+    held_ = held;
+
+    if (!held_ && !queue_.empty())
+        startWriting();
+}
+
+void Connection::compress(const Compression compression) {
+    const std::lock_guard queue_lock { queue_mtx_ };
+
+    if (compression == Compression::Deflate)
+        compressor_ = std::make_unique<Compressor>();
+    else
+        compressor_.reset();
+}
+
+void Connection::cancel() {
+    cancellations_++;
+
+    // Le socket n'est manipulé que sur son executor, par lequel passent aussi les réceptions en cours
+    io::post(socket_.get_executor(), [self { shared_from_this() }]() {
+        ErrCode cancel_err;
+        self->socket_.cancel(cancel_err);
+    });
+}
+
+void Connection::discardReceived() {
+    received_begin_ = 0;
+    received_count_ = 0;
+}
+
+std::optional<std::size_t> Connection::bufferedFrame(const FrameType type, bool& oversized) const {
+    constexpr std::size_t max_length { std::tuple_size_v<ReceiveBuffer> };
+    const std::size_t scanned { std::min(received_count_, max_length) };
+
+    oversized = false;
+    if (type == FrameType::Byte)
+        return received_count_ == 0 ? std::optional<std::size_t> {} : 1;
+
+    // Une chaîne se termine par son caractère nul, précédé de l'ID du client pour IdentifiedString
+    for (std::size_t i { type == FrameType::IdentifiedString ? std::size_t { 1 } : 0 }; i < scanned; i++) {
+        if (receivedAt(i) == 0)
+            return i + 1;
+    }
+
+    oversized = received_count_ >= max_length;
+    return {};
+}
+
+void Connection::receive(const FrameType type, FrameHandler handler) {
+    const std::size_t generation { cancellations_ };
+
+    bool oversized;
+    if (bufferedFrame(type, oversized) || oversized) {
+        // Le handler n'est jamais appelé avant le retour, l'appelant peut garder des verrous que celui-ci utilise
+        io::post(socket_.get_executor(), [self { shared_from_this() }, type, generation, handler { std::move(handler) }]() {
+            self->deliverFrame(type, generation, handler);
+        });
+
+        return;
+    }
+
+    readMore(type, generation, std::move(handler));
+}
+
+void Connection::readMore(const FrameType type, const std::size_t generation, FrameHandler handler) {
+    const std::size_t end { (received_begin_ + received_count_) % RECEIVE_CAPACITY };
+    const std::size_t free_space { RECEIVE_CAPACITY - received_count_ };
+    const std::size_t contiguous_space { std::min(free_space, RECEIVE_CAPACITY - end) };
+
+    const std::array<io::mutable_buffer, 2> space {
+        io::buffer(received_.data() + end, contiguous_space), io::buffer(received_.data(), free_space - contiguous_space)
+    };
+
+    socket_.async_read_some(space, [self { shared_from_this() }, type, generation, handler { std::move(handler) }](const ErrCode err, const std::size_t length) {
+        self->received_count_ += length;
+
+        if (err)
+            handler(err, {}, 0);
+        else
+            self->deliverFrame(type, generation, handler);
+    });
+}
+
+void Connection::deliverFrame(const FrameType type, const std::size_t generation, const FrameHandler& handler) {
+    if (generation != cancellations_) {
+        handler(io::error::basic_errors::operation_aborted, {}, 0);
+        return;
+    }
+
+    bool oversized;
+    const std::optional<std::size_t> frame_length { bufferedFrame(type, oversized) };
+
+    if (oversized) {
+        handler(io::error::basic_errors::message_size, {}, 0);
+        return;
+    }
+
+    if (!frame_length) {
+        readMore(type, generation, handler);
+        return;
+    }
+
+    ReceiveBuffer frame;
+    frame.fill(0);
+    for (std::size_t i { 0 }; i < *frame_length; i++)
+        frame[i] = receivedAt(i);
+
+    received_begin_ = (received_begin_ + *frame_length) % RECEIVE_CAPACITY;
+    received_count_ -= *frame_length;
+
+    handler({}, frame, *frame_length);
+}
+
+void Connection::shutdown() {
+    const std::lock_guard queue_lock { queue_mtx_ };
+    shutdown_requested_ = true;
+    held_ = false;
+
+    startWriting();
+}
+
+void Connection::writeNext() {
+    std::unique_lock queue_lock { queue_mtx_ };
+    if (err_) {
+        failQueued(queue_lock);
+        return;
+    }
+
+    if (queue_.empty() || held_) {
+        writing_ = false;
+
+        if (queue_.empty() && shutdown_requested_) {
+            ErrCode shutdown_err;
+            socket_.shutdown(tcp::socket::shutdown_both, shutdown_err);
+        }
+
+        return;
+    }
+
+    // Les paquets en file sont partagés avec les autres destinataires, ils restent valides jusqu'à leur retrait.
+    // Ils sont écrits ensemble, le premier pouvant l'avoir déjà été en partie.
+    const std::size_t gathered { std::min(queue_.size(), MAX_GATHERED_PACKETS) };
+
+    std::vector<io::const_buffer> remaining;
+    remaining.reserve(gathered);
+
+    std::size_t skipped { written_ };
+    for (std::size_t i { 0 }; i < gathered; i++) {
+        gather(queue_[i].packet, skipped, remaining);
+        skipped = 0;
+    }
+
+    queue_lock.unlock();
+
+    io::async_write(socket_, remaining, [self { shared_from_this() }](const ErrCode err, const std::size_t length) {
+        self->handleWrite(err, length);
+    });
+}
+
+void Connection::failQueued(std::unique_lock<std::mutex>& queue_lock) {
+    std::deque<PendingPacket> failed;
+    std::swap(failed, queue_);
+
+    pending_bytes_ = 0;
+    written_ = 0;
+    writing_ = false;
+
+    const ErrCode reported_err { err_ };
+    queue_lock.unlock();
+
+    for (const PendingPacket& packet : failed) {
+        if (packet.handler)
+            packet.handler(reported_err, 0);
+    }
+}
+
+void Connection::handleWrite(const ErrCode err, const std::size_t length) {
+    std::unique_lock queue_lock { queue_mtx_ };
+    written_ += length;
+
+    if (err == io::error::basic_errors::operation_aborted && socket_.is_open()) {
+        queue_lock.unlock();
+        writeNext();
+
+        return;
+    }
+
+    if (err) {
+        if (!err_)
+            err_ = err;
+
+        failQueued(queue_lock);
+        return;
+    }
+
+    std::vector<PendingPacket> sent;
+    while (!queue_.empty() && written_ >= queue_.front().packet.count()) {
+        written_ -= queue_.front().packet.count();
+        pending_bytes_ -= queue_.front().packet.count();
+
+        sent.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+    }
+
+    queue_lock.unlock();
+
+    for (const PendingPacket& packet : sent) {
+        if (packet.handler)
+            packet.handler({}, packet.packet.count());
+    }
+
+    writeNext();
+}
+
+} // namespace Rbo
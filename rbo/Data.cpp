@@ -2,31 +2,82 @@
 
 namespace Rbo {
 
-Data::Data() {
-    assert(LENGTH_SIZE <= std::numeric_limits<byte>::max());
+Data::Data() : buffer_ { nullptr }, capacity_ { INLINE_DATA_CAPACITY }, bytes_ { LENGTH_SIZE } {
+    static_assert(LENGTH_SIZE <= INLINE_DATA_CAPACITY);
 
-    buffer_.fill(0);
-    bytes_ += LENGTH_SIZE;
+    // Seule la longueur est initialisée, le reste du tampon l'est au fur et à mesure des ajouts
+    buffer_ = inline_buffer_.data();
+    std::fill_n(buffer_, LENGTH_SIZE, 0);
 }
 
 Data::Data(const std::vector<byte>& data) : Data {} {
-    if (data.size() > MAX_LENGTH - LENGTH_SIZE)
+    reserve(data.size());
+
+    std::copy(data.cbegin(), data.cend(), buffer_ + bytes_);
+    bytes_ += data.size();
+}
+
+Data::Data(const Data& rhs) : Data {} {
+    reserve(rhs.count() - LENGTH_SIZE);
+
+    std::copy_n(rhs.buffer(), rhs.count(), buffer_);
+    bytes_ = rhs.count();
+}
+
+Data::Data(Data&& rhs) noexcept : Data {} {
+    take(rhs);
+}
+
+Data& Data::operator=(Data rhs) noexcept {
+    take(rhs);
+
+    return *this;
+}
+
+void Data::take(Data& rhs) noexcept {
+    capacity_ = rhs.capacity_;
+    bytes_ = rhs.bytes_;
+    heap_buffer_ = std::move(rhs.heap_buffer_);
+
+    // Un tampon interne ne peut pas être volé, seul son contenu utile est copié
+    if (heap_buffer_) {
+        buffer_ = heap_buffer_.get();
+    } else {
+        buffer_ = inline_buffer_.data();
+        std::copy_n(rhs.inline_buffer_.cbegin(), bytes_, buffer_);
+    }
+
+    rhs.buffer_ = rhs.inline_buffer_.data();
+    rhs.capacity_ = INLINE_DATA_CAPACITY;
+    rhs.bytes_ = LENGTH_SIZE;
+    std::fill_n(rhs.buffer_, LENGTH_SIZE, 0);
+}
+
+void Data::reserve(const std::size_t additional_bytes) {
+    const std::size_t required { count() + additional_bytes };
+    if (required > LENGTH_SIZE + MAX_CONTENT_LENGTH)
         throw BufferOverflow {};
 
-    std::size_t i { 0 };
-    for (const byte b : data)
-        buffer_[LENGTH_SIZE + i++] = b;
+    if (required <= capacity_)
+        return;
 
-    bytes_ += data.size();
+    // Capacité doublée pour que les ajouts successifs n'entraînent qu'un nombre logarithmique de copies
+    const std::size_t new_capacity { std::min(std::max(required, capacity_ * 2), LENGTH_SIZE + MAX_CONTENT_LENGTH) };
+    std::unique_ptr<byte[]> new_buffer { new byte[new_capacity] };
+
+    std::copy_n(buffer_, count(), new_buffer.get());
+
+    heap_buffer_ = std::move(new_buffer);
+    buffer_ = heap_buffer_.get();
+    capacity_ = new_capacity;
 }
 
 bool Data::operator==(const Data& rhs) const {
-    return count() == rhs.count() && buffer() == rhs.buffer();
+    return count() == rhs.count() && std::equal(buffer(), buffer() + count(), rhs.buffer());
 }
 
 void Data::add(const byte b) {
-    if (count() + 1 > MAX_LENGTH)
-        throw BufferOverflow {};
+    reserve(1);
 
     buffer_[bytes_++] = b;
 }
@@ -36,31 +87,143 @@ void Data::add(const bool b) {
 }
 
 void Data::put(const std::string& str) {
-    if (count() + str.length() + sizeof(word) > MAX_LENGTH)
-        throw BufferOverflow {};
+    if (str.length() > std::numeric_limits<word>::max())
+        throw StringTooLong { str.length() };
+
+    reserve(str.length() + sizeof(word));
 
     putNumeric<word>(str.length());
-    for (const std::size_t init { bytes_ }; bytes_ < (str.length() + init); bytes_++)
-        buffer_[bytes_] = str[bytes_ - init];
+    std::copy(str.cbegin(), str.cend(), buffer_ + bytes_);
+    bytes_ += str.length();
 }
 
 void Data::putList(const OptionsList& options) {
+    if (options.size() > std::numeric_limits<byte>::max())
+        throw ListTooLong { options.size() };
+
     const std::size_t total = std::accumulate(options.cbegin(), options.cend(), std::size_t { count() + 1 }, [](const std::size_t size, const std::string& option) {
         return size + STR_LENGTH_SIZE + option.length();
     });
 
-    if (total > MAX_LENGTH)
-        throw BufferOverflow {};
+    reserve(total - count());
 
     add(static_cast<byte>(options.size()));
     for (const std::string& option : options)
         put(option);
 }
 
-const Data& DataFactory::dataWithLength() {
-    data_.refreshLength();
+void Data::putBytes(const byte* const bytes, const std::size_t length) {
+    reserve(length);
+
+    std::copy_n(bytes, length, buffer_ + bytes_);
+    bytes_ += length;
+}
+
+void Data::putVarint(ulong value) {
+    std::array<byte, MAX_VARINT_SIZE> encoded;
+    std::size_t size { 0 };
+
+    do {
+        encoded[size] = static_cast<byte>(value & 0x7F);
+        value >>= 7;
+
+        if (value != 0)
+            encoded[size] |= 0x80;
+
+        size++;
+    } while (value != 0);
+
+    reserve(size);
+
+    std::copy_n(encoded.cbegin(), size, buffer_ + bytes_);
+    bytes_ += size;
+}
+
+void Data::putSignedVarint(const std::int64_t value) {
+    putVarint(zigzag(value));
+}
+
+const byte* DataReader::take(const std::size_t length) {
+    if (length > remaining())
+        throw MalformedData { "expected " + std::to_string(length) + " more bytes, " + std::to_string(remaining()) + " remaining" };
+
+    const byte* const value { data_ + position_ };
+    position_ += length;
+
+    return value;
+}
+
+std::string DataReader::getString() {
+    const std::size_t length { getNumeric<word>() };
+    const byte* const characters { take(length) };
+
+    return { characters, characters + length };
+}
+
+OptionsList DataReader::getList() {
+    OptionsList options;
+    options.resize(get());
+
+    for (std::string& option : options)
+        option = getString();
+
+    return options;
+}
+
+ulong DataReader::getVarint() {
+    ulong value { 0 };
+
+    for (std::size_t i { 0 }; i < Data::MAX_VARINT_SIZE; i++) {
+        const byte b { get() };
+        value |= static_cast<ulong>(b & 0x7F) << (7 * i);
+
+        if ((b & 0x80) == 0)
+            return value;
+    }
+
+    throw MalformedData { "varint longer than " + std::to_string(Data::MAX_VARINT_SIZE) + " bytes" };
+}
+
+Packet::Packet(std::shared_ptr<const Data> data) : data_ { std::move(data) }, count_ { data_->count() } {
+    if (count_ <= MAX_LENGTH)
+        return;
+
+    const std::size_t content_length { count_ - Data::LENGTH_SIZE };
+    const std::size_t fragments_count { (content_length + MAX_FRAGMENT_CONTENT - 1) / MAX_FRAGMENT_CONTENT };
+
+    // Seuls les en-têtes sont alloués, le contenu des fragments est lu directement dans les données du message
+    auto headers { std::make_shared<std::vector<byte>>(fragments_count * FRAGMENT_HEADER_SIZE) };
+    for (std::size_t i { 0 }; i < fragments_count; i++) {
+        byte* const header { headers->data() + i * FRAGMENT_HEADER_SIZE };
+        const std::size_t fragment_content { std::min(MAX_FRAGMENT_CONTENT, content_length - i * MAX_FRAGMENT_CONTENT) };
+
+        writeBigEndian(static_cast<word>(FRAGMENT_HEADER_SIZE + fragment_content), header);
+        header[Data::LENGTH_SIZE] = FRAGMENT_EVENT;
+        writeBigEndian(static_cast<word>(i), header + Data::LENGTH_SIZE + 1);
+        writeBigEndian(static_cast<word>(fragments_count), header + Data::LENGTH_SIZE + 1 + sizeof(word));
+    }
+
+    fragment_headers_ = std::move(headers);
+    count_ = content_length + fragments_count * FRAGMENT_HEADER_SIZE;
+}
+
+Packet::Fragment Packet::fragment(const std::size_t i) const {
+    assert(fragmented() && i < fragments());
+
+    const std::size_t offset { i * MAX_FRAGMENT_CONTENT };
+    const std::size_t content_length { data_->count() - Data::LENGTH_SIZE };
+
+    return {
+        fragment_headers_->data() + i * FRAGMENT_HEADER_SIZE,
+        data_->buffer() + Data::LENGTH_SIZE + offset,
+        std::min(MAX_FRAGMENT_CONTENT, content_length - offset)
+    };
+}
+
+Packet DataFactory::dataWithLength() {
+    data_->refreshLength();
 
-    return data_;
+    return Packet { data_ };
 }
 
 } // namespace Rbo
@@ -0,0 +1,48 @@
+#include <Rbo/Dictionary.hpp>
+
+#include <Rbo/Game.hpp>
+
+namespace Rbo {
+
+Symbols::Symbols(std::vector<std::string> names) : names_ { std::move(names) } {
+    assert(names_.size() <= std::numeric_limits<word>::max());
+
+    std::sort(names_.begin(), names_.end());
+
+    for (std::size_t i { 0 }; i < names_.size(); i++)
+        ids_.insert({ names_[i], static_cast<word>(i) });
+}
+
+word Symbols::id(const std::string& name) const {
+    const auto symbol { ids_.find(name) };
+    if (symbol == ids_.cend())
+        throw UnknownSymbol { name };
+
+    return symbol->second;
+}
+
+namespace {
+
+template<typename Descriptors>
+std::vector<std::string> keys(const Descriptors& descriptors) {
+    std::vector<std::string> names;
+    names.reserve(descriptors.size());
+
+    for (const auto& descriptor : descriptors)
+        names.push_back(descriptor.first);
+
+    return names;
+}
+
+}
+
+Dictionary::Dictionary(const Game& game)
+    : globals_ { keys(game.globalStats) },
+      stats_ { keys(game.playerStats) },
+      inventories_ { keys(game.playerInventories) },
+      enemies_ { keys(game.enemies) } {
+    for (const std::string& inventory : inventories_.names())
+        items_.emplace_back(game.playerInventories.at(inventory).items);
+}
+
+} // namespace Rbo
@@ -219,10 +219,14 @@ void Gameplay::printTitle(const std::string& title) {
 }
 
 void Gameplay::sendGlobalStat(const std::string& stat) {
-    SessionDataFactory data_factory;
-    data_factory.makeGlobalStat(stat, global().raw().at(stat));
+    const Stat& value { global().raw().at(stat) };
 
-    ctx_.sendToAll(data_factory.dataWithLength());
+    ctx_.sendToAll([this, &stat, &value](SessionDataFactory& data_factory, const Protocol protocol) {
+        if (protocol == Protocol::Binary)
+            data_factory.makeGlobalStat(stat, value, ctx_.dictionary());
+        else
+            data_factory.makeGlobalStat(stat, value);
+    });
 }
 
 void Gameplay::initCache(const byte player_id) {
@@ -284,26 +288,34 @@ void Gameplay::sendPlayerUpdate(const byte id) {
         }
     }
 
-    SessionDataFactory data_factory;
-    data_factory.makePlayerUpdate(id, update);
-
-    ctx_.sendToAll(data_factory.dataWithLength());
+    ctx_.sendToAll([this, id, &update](SessionDataFactory& data_factory, const Protocol protocol) {
+        if (protocol == Protocol::Binary)
+            data_factory.makePlayerUpdate(id, update, ctx_.dictionary());
+        else
+            data_factory.makePlayerUpdate(id, update);
+    });
 
     cache_initialized = true;
 }
 
 void Gameplay::sendBattleInit(const GroupDescriptor& entities) {
-    SessionDataFactory data_factory;
-    data_factory.makeBattleInit(entities, game());
+    battle_group_ = entities;
 
-    ctx_.sendToAll(data_factory.dataWithLength());
+    ctx_.sendToAll([this](SessionDataFactory& data_factory, const Protocol protocol) {
+        if (protocol == Protocol::Binary)
+            data_factory.makeBattleInit(battle_group_, game(), ctx_.dictionary());
+        else
+            data_factory.makeBattleInit(battle_group_, game());
+    });
 }
 
 void Gameplay::sendBattleAtk(const byte p_id, const std::string& enemy, const int dmg) {
-    SessionDataFactory data_factory;
-    data_factory.makeBattleAtk(p_id, enemy, dmg);
-
-    ctx_.sendToAll(data_factory.dataWithLength());
+    ctx_.sendToAll([this, p_id, &enemy, dmg](SessionDataFactory& data_factory, const Protocol protocol) {
+        if (protocol == Protocol::Binary)
+            data_factory.makeBattleAtk(p_id, enemy, dmg, battle_group_);
+        else
+            data_factory.makeBattleAtk(p_id, enemy, dmg);
+    });
 }
 
 void Gameplay::sendBattleEnd() {
@@ -158,5 +158,20 @@ void from_json(const json& data, std::unordered_map<byte, PlayerState>& players)
     }
 }
 
+void to_json(json& data, const GameState& state) {
+    data = json::object();
+    data["scene"] = state.scene;
+    data["global"] = state.global;
+    data["leader"] = state.leader;
+    data["players"] = state.players;
+}
+
+void from_json(const json& data, GameState& state) {
+    data.at("scene").get_to(state.scene);
+    data.at("global").get_to(state.global);
+    data.at("leader").get_to(state.leader);
+    data.at("players").get_to(state.players);
+}
+
 
 } // namespace Rbo
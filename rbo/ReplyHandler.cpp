@@ -5,29 +5,37 @@
 
 namespace Rbo {
 
-ReplyHandler::ReplyHandler(spdlog::logger& logger, RequestCtx& ctx, const ReplyController controller, const byte p_id)
+ReplyHandler::ReplyHandler(spdlog::logger& logger, std::shared_ptr<RequestCtx> ctx, const ReplyController controller, const byte p_id)
     : logger_ { logger },
-      ctx_ { ctx },
+      ctx_ { std::move(ctx) },
       controlValidity { controller },
       playerID_ { p_id },
       replyBuffer_ {} {}
 
+void ReplyHandler::replyHandled() const {
+    ctx_->repliesHandled++;
+
+    // La Session est réveillée une seule fois, lorsque la dernière réponse attendue a été traitée
+    if (ctx_->repliesHandled == ctx_->repliesToReceive)
+        ctx_->completion.notify();
+}
+
 void ReplyHandler::reportError(const byte player_id, const NetworkError& error) const {
     logger_.error("Failed to handle reply of [{}] : {}", playerID_, error.what());
-    ctx_.errorIDs.push_back(player_id);
+    ctx_->errorIDs.push_back(player_id);
 }
 
 void ReplyHandler::handleError(const NetworkError& error) const {
     reportError(playerID_, error);
-    ctx_.repliesHandled++;
+    replyHandled();
 }
 
-ReplyValidity ReplyHandler::treatReply(const std::size_t length) {
+ReplyValidity ReplyHandler::treatReply([[maybe_unused]] const std::size_t length) {
+    // Les réponses sont reçues comme des trames d'un octet
+    assert(length == 1);
+
     byte reply;
     try {
-        if (length != 1)
-            throw InvalidReply { ReplyValidity::InvalidLengthError };
-
         reply = replyBuffer_[0];
 
         controlValidity(reply);
@@ -35,18 +43,18 @@ ReplyValidity ReplyHandler::treatReply(const std::size_t length) {
         return err.type;
     }
 
-    if (ctx_.replies.size() >= ctx_.repliesToAccept) {
+    if (ctx_->replies.size() >= ctx_->repliesToAccept) {
         logger_.info("Reply of [{}] ignored (too late).", playerID_);
         return ReplyValidity::TooLate;
     }
 
     SessionDataFactory anwser;
     anwser.makeReply(playerID_, reply);
-    const io::const_buffer anwser_buffer { trunc(anwser.dataWithLength()) };
+    const Packet anwser_data { anwser.dataWithLength() };
 
-    for (auto [remote_id, remote_player] : ctx_.players) {
+    for (const auto& [remote_id, remote_player] : ctx_->players) {
         try {
-            const ErrCode send_err { trySend(remote_player.connection, anwser_buffer) };
+            const ErrCode send_err { remote_player.connection->send(anwser_data) };
 
             if (send_err)
                 throw NetworkError { "send_reply:" + std::to_string(remote_id), send_err };
@@ -56,14 +64,14 @@ ReplyValidity ReplyHandler::treatReply(const std::size_t length) {
     }
 
     logger_.info("Reply of [{}] : {}", playerID_, reply);
-    ctx_.replies.insert({ playerID_, reply });
+    ctx_->replies.insert({ playerID_, reply });
 
     return ReplyValidity::Ok;
 }
 
 void ReplyHandler::handleReply(const ErrCode r_err, const std::size_t length) {
-    const std::lock_guard request_lock { ctx_.requestMtx };
-    if (ctx_.requestDone) {
+    const std::lock_guard request_lock { ctx_->requestMtx };
+    if (ctx_->requestDone) {
         logger_.debug("Request handling for [{}] canceled, request is done.", playerID_);
         return;
     }
@@ -71,7 +79,7 @@ void ReplyHandler::handleReply(const ErrCode r_err, const std::size_t length) {
     logger_.debug("Handling reply for [{}].", playerID_);
     try {
         if (r_err) {
-            if (r_err == io::error::basic_errors::operation_aborted && ctx_.requestDone) {
+            if (r_err == io::error::basic_errors::operation_aborted && ctx_->requestDone) {
                 logger_.debug("Reply handling canceled for [{}].", playerID_);
                 return;
             }
@@ -84,7 +92,7 @@ void ReplyHandler::handleReply(const ErrCode r_err, const std::size_t length) {
         SessionDataFactory validity_data;
         validity_data.makeValidation(reply_validity);
 
-        const ErrCode validation_err { trySend(ctx_.players.at(playerID_).connection, trunc(validity_data.dataWithLength())) };
+        const ErrCode validation_err { ctx_->players.at(playerID_).connection->send(validity_data.dataWithLength()) };
 
         if (validation_err)
             throw NetworkError { "send_validation", validation_err };
@@ -94,7 +102,7 @@ void ReplyHandler::handleReply(const ErrCode r_err, const std::size_t length) {
             listenReply();
         } else {
             logger_.info("Reply of [{}] is valid.", playerID_);
-            ctx_.repliesHandled++;
+            replyHandled();
         }
     } catch (const NetworkError& err) {
         handleError(err);
@@ -104,14 +112,15 @@ void ReplyHandler::handleReply(const ErrCode r_err, const std::size_t length) {
 void ReplyHandler::listenReply() {
     logger_.debug("Listening reply for [{}]...", playerID_);
 
-    ctx_.players.at(playerID_).connection.async_receive(io::buffer(replyBuffer_), [this](const ErrCode err, const std::size_t len) {
-        handleReply(err, len);
+    ctx_->players.at(playerID_).connection->receive(FrameType::Byte, [self { shared_from_this() }](const ErrCode err, const ReceiveBuffer& reply, const std::size_t len) {
+        self->replyBuffer_ = reply;
+        self->handleReply(err, len);
     });
 }
 
 void ReplyHandler::handle(const ErrCode send_err, const std::size_t) {
-    const std::lock_guard request_lock { ctx_.requestMtx };
-    if (ctx_.requestDone) {
+    const std::lock_guard request_lock { ctx_->requestMtx };
+    if (ctx_->requestDone) {
         logger_.debug("Request handling for [{}] canceled, request is done.", playerID_);
         return;
     }
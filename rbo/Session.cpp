@@ -1,5 +1,6 @@
 #include <Rbo/Session.hpp>
 
+#include <thread>
 #include <spdlog/logger.h>
 #include <spdlog/fmt/ostr.h>
 #include <Rbo/SessionDataFactory.hpp>
@@ -35,10 +36,10 @@ std::string initStatMsg(const DicesRoll& init, const std::string& name, const in
 
 }
 
-tcp::socket& Session::connection(const byte id) {
+Connection& Session::connection(const byte id) {
     assert(connections_.count(id) == 1);
 
-    return connections_.at(id);
+    return *connections_.at(id);
 }
 
 void Session::logPlayerError(const byte player, const std::string& err) {
@@ -47,7 +48,7 @@ void Session::logPlayerError(const byte player, const std::string& err) {
 
 void Session::disconnect(const byte id, const bool crash) {
     if (!crash)
-        connection(id).shutdown(tcp::socket::shutdown_both);
+        connection(id).shutdown();
 
     removePlayer(id);
 
@@ -68,16 +69,31 @@ void Session::disconnect(const byte id, const bool crash) {
 void Session::removePlayer(const byte id) {
     players_.erase(id);
     connections_.erase(id);
+    protocols_.erase(id);
 }
 
-std::size_t Session::counter_ { 0 };
+std::atomic<std::size_t> Session::counter_ { 0 };
 
-Session::Session(const GameBuilder& g_builder)
+Session::Session(const GameBuilder& g_builder, OptionalCoroutine coroutine)
         : logger_ { rboLogger("Session-" + std::to_string(counter_++)) },
           game_builder_ { g_builder },
           game_ { g_builder() },
+          dictionary_ { *game_ },
           running_ { false },
-          current_scene_ { 0 } {}
+          coroutine_ { std::move(coroutine) },
+          current_request_ { nullptr },
+          current_scene_ { 0 },
+          sends_held_ { false } {}
+
+void Session::stop() {
+    running_ = false;
+
+    const std::lock_guard current_request_lock { current_request_mtx_ };
+    if (current_request_) {
+        const std::lock_guard request_lock { current_request_->requestMtx };
+        current_request_->completion.notify();
+    }
+}
 
 void Session::begin(Entrants& entrants) {
     for (auto& [id, entrant] : entrants) {
@@ -86,13 +102,24 @@ void Session::begin(Entrants& entrants) {
         Player player { id, std::move(entrant.name), game().player(), game().itemsList(), game().bonuses };
 
         players_.insert({ id, std::move(player) });
-        connections_.insert({ id, std::move(entrant.socket) });
+        connections_.insert({ id, std::move(entrant.connection) });
+        protocols_.insert({ id, entrant.protocol });
     }
 
     SessionDataFactory start_msg;
     start_msg.makeStart(game().name);
 
     sendToAll(start_msg.dataWithLength());
+
+    // Le dictionnaire précède tout paquet y faisant référence
+    SessionDataFactory dictionary_msg;
+    dictionary_msg.makeDictionary(dictionary());
+
+    const Packet dictionary_data { dictionary_msg.dataWithLength() };
+    for (const byte id : ids()) {
+        if (protocol(id) == Protocol::Binary)
+            sendTo(id, dictionary_data);
+    }
 }
 
 void Session::end(Entrants& entrants) {
@@ -107,7 +134,7 @@ void Session::end(Entrants& entrants) {
             logger_.trace("Moving socket of entrant [{}]...", id);
 
             entrant.name = player(id).name();
-            entrant.socket = std::move(connection(id));
+            entrant.connection = std::move(connections_.at(id));
         } else {
             error_ids.push_back(id);
         }
@@ -169,10 +196,12 @@ word Session::gameFromCheckpoint(const std::string& final_name, const bool missi
         stats().setHidden(name, hidden);
         stats().setMain(name, main);
 
-        SessionDataFactory global_stat;
-        global_stat.makeGlobalStat(name, stat);
-
-        sendToAll(global_stat.dataWithLength());
+        sendToAll([this, &name = name, &stat = stat](SessionDataFactory& global_stat, const Protocol protocol) {
+            if (protocol == Protocol::Binary)
+                global_stat.makeGlobalStat(name, stat, dictionary());
+            else
+                global_stat.makeGlobalStat(name, stat);
+        });
     }
 
     const EntrantsValidity entrants_validity { checkEntrants(checkpoint, missing_entrants) };
@@ -398,6 +427,8 @@ void Session::start(Entrants& initial_entrants_data, const std::string& checkpoi
             interface.sendGlobalStat(stat.first);
 
         for (Next next { beginning }; next && running(); next = playScene(interface, *next));
+
+        reportSaveFailures(true);
     } catch (const std::exception& err) {
         end(initial_entrants_data);
         running_ = false;
@@ -413,25 +444,97 @@ void Session::reset() {
     stats_ = {};
     players_.clear();
     connections_.clear();
+    protocols_.clear();
     leader_.reset();
     current_scene_ = 0;
+    pending_saves_.clear();
+}
+
+void Session::reportSaveFailures(const bool wait_all) {
+    if (wait_all && coroutine_)
+        waitSavesWritten();
+
+    for (auto saved { pending_saves_.begin() }; saved != pending_saves_.end();) {
+        // Une sauvegarde sans écriture différée est déjà terminée
+        if (saved->written.valid()) {
+            if (!wait_all && saved->written.wait_for(std::chrono::seconds { 0 }) != std::future_status::ready) {
+                saved++;
+                continue;
+            }
+
+            try {
+                saved->written.get();
+            } catch (const std::exception& err) {
+                logger_.error("Checkpoint \"{}\" not saved : {}", saved->name, err.what());
+
+                SessionDataFactory failure_msg;
+                failure_msg.makeImportantText("Checkpoint \"" + saved->name + "\" couldn't be saved");
+
+                sendToAll(failure_msg.dataWithLength());
+            }
+        }
+
+        saved = pending_saves_.erase(saved);
+    }
+}
+
+void Session::waitSavesWritten() {
+    struct SavesWritten {
+        std::mutex mtx;
+        Completion completion;
+        bool done { false };
+    };
+
+    std::vector<std::shared_future<void>> written;
+    for (const SavedCheckpoint& saved : pending_saves_) {
+        if (saved.written.valid())
+            written.push_back(saved.written);
+    }
+
+    if (written.empty())
+        return;
+
+    // Un future ne peut pas réveiller une coroutine, un thread dédié attend donc les écritures à sa place
+    const std::shared_ptr<SavesWritten> state { std::make_shared<SavesWritten>() };
+    std::thread { [state, written]() {
+        for (const std::shared_future<void>& save : written)
+            save.wait();
+
+        const std::lock_guard written_lock { state->mtx };
+        state->done = true;
+        state->completion.notify();
+    } }.detach();
+
+    std::unique_lock written_lock { state->mtx };
+    state->completion.wait(written_lock, [&state]() { return state->done; }, coroutine_);
 }
 
 Next Session::playScene(Gameplay& interface, const word id) {
     logger_.info("Go to scene {}.", id);
+    reportSaveFailures(false);
+
     current_scene_ = id;
-    const Scene scene { gameBuilder().buildScene(id) };
+    const ScenePtr scene { gameBuilder().buildScene(id) };
 
     SessionDataFactory switch_msg;
     switch_msg.makeSwitch(id);
 
     sendToAll(switch_msg.dataWithLength());
 
-    for (const Instruction& step : scene) {
+    // Les paquets envoyés pendant une instruction sont écrits ensemble à sa fin, ou avant une requête
+    struct HeldSends {
+        Session& session;
+
+        explicit HeldSends(Session& s) : session { s } { session.holdSends(true); }
+        ~HeldSends() { session.holdSends(false); }
+    };
+
+    for (const Instruction& step : *scene) {
         if (!running())
             break;
 
         try {
+            const HeldSends held_sends { *this };
             const Next result { step(interface) };
 
             if (result)
@@ -447,6 +550,13 @@ Next Session::playScene(Gameplay& interface, const word id) {
     return {};
 }
 
+void Session::holdSends(const bool held) {
+    sends_held_ = held;
+
+    for (auto& connection : connections_)
+        connection.second->hold(held);
+}
+
 byte Session::leader() const {
     if (!leader_)
         throw UninitializedLeader {};
@@ -464,7 +574,7 @@ void Session::switchLeader(const byte id) {
     sendToAll(switch_data.dataWithLength());
 }
 
-std::string Session::checkpoint(const std::string& chkpt_name, const word id) const {
+std::string Session::checkpoint(const std::string& chkpt_name, const word id) {
     if (current_scene_ == INTRO)
         throw IntroductionCheckpoint {};
 
@@ -483,7 +593,10 @@ std::string Session::checkpoint(const std::string& chkpt_name, const word id) co
         return { id, PlayerState { player.alive() ? Death {} : Death { player.death() }, stats, inventories, capacities } };
     });
 
-    return gameBuilder().save(chkpt_name, { id, stats().raw(), leader(), states });
+    SavedCheckpoint saved { gameBuilder().save(chkpt_name, { id, stats().raw(), leader(), states }) };
+    pending_saves_.push_back(saved);
+
+    return saved.name;
 }
 
 std::vector<byte> Session::ids() const {
@@ -546,8 +659,10 @@ bool Session::anyPlayerAlive() const {
     return std::any_of(players_.cbegin(), players_.cend(), [](const auto& p) -> bool { return p.second.alive(); });
 }
 
-Replies Session::request(const byte targets_id, const Data& data, ReplyController controller, const bool first_reply_only, const bool wait_all_replies) {
-    RequestCtx ctx;
+Replies Session::request(const byte targets_id, const Packet& data, ReplyController controller, const bool first_reply_only, const bool wait_all_replies) {
+    // Partagé avec les handlers d'E/S, qui peuvent encore être appelés une fois la requête terminée
+    const std::shared_ptr<RequestCtx> shared_ctx { std::make_shared<RequestCtx>() };
+    RequestCtx& ctx { *shared_ctx };
 
     const bool all_players { targets_id == ALL_PLAYERS };
     const bool alive_players { targets_id == ACTIVE_PLAYERS };
@@ -561,58 +676,74 @@ Replies Session::request(const byte targets_id, const Data& data, ReplyControlle
             targets_count++;
     }
 
-    byte replies_to_receive;
     if (first_reply_only) {
         ctx.repliesToAccept = 1;
-        replies_to_receive = wait_all_replies ? targets_count : 1;
+        ctx.repliesToReceive = wait_all_replies ? targets_count : 1;
     } else {
         ctx.repliesToAccept = targets_count;
-        replies_to_receive = targets_count;
+        ctx.repliesToReceive = targets_count;
     }
 
-    const io::const_buffer buffer { trunc(data) };
-    std::map<byte, ReplyHandler> handlers;
-    for (auto [id, player] : ctx.players) {
+    std::unique_lock current_request_lock { current_request_mtx_ };
+    current_request_ = &ctx;
+    current_request_lock.unlock();
+
+    const std::vector<std::pair<byte, RequestProfile>> profiles { ctx.players.cbegin(), ctx.players.cend() };
+    for (const auto& [id, player] : profiles) {
         if (player.isTarget) {
-            handlers.try_emplace(id, logger_, ctx, controller, id);
+            const std::shared_ptr<ReplyHandler> handler { std::make_shared<ReplyHandler>(logger_, shared_ctx, controller, id) };
+
+            // La réponse est attendue une fois la requête écrite, après les paquets déjà en file pour ce joueur
+            const ErrCode send_err { player.connection->send(data, [handler](const ErrCode err, const std::size_t len) {
+                handler->handle(err, len);
+            }) };
 
-            const byte player_id { id }; // Nécessaire pour pouvoir être capturé par la lambda
-            player.connection.async_send(buffer, [&handlers, player_id](const ErrCode err, const std::size_t len) {
-                handlers.at(player_id).handle(err, len);
-            });
+            if (send_err)
+                handler->handle(send_err, 0);
         } else {
-            const ErrCode send_err { trySend(player.connection, buffer) };
+            const ErrCode send_err { player.connection->send(data) };
 
             if (send_err) {
+                const std::lock_guard request_lock { ctx.requestMtx };
+
                 ctx.players.erase(ctx.players.find(id));
                 ctx.errorIDs.push_back(id);
             }
         }
     }
 
-    logger_.info("Waiting for {} replies in total...", replies_to_receive);
-    while (ctx.repliesHandled < replies_to_receive && running())
-        std::this_thread::sleep_for(std::chrono::milliseconds { 1 });
-    logger_.info("{} replies received.", ctx.repliesHandled.load());
+    // Les joueurs doivent recevoir la requête pour y répondre
+    const bool sends_held { sends_held_ };
+    if (sends_held)
+        holdSends(false);
+
+    logger_.info("Waiting for {} replies in total...", ctx.repliesToReceive);
 
     std::unique_lock request_lock { ctx.requestMtx };
+    ctx.completion.wait(request_lock, [this, &ctx]() { return ctx.completed() || !running(); }, coroutine_);
+
+    logger_.info("{} replies received.", ctx.repliesHandled.load());
 
     ctx.requestDone = true;
     for (auto& player : ctx.players)
-        player.second.connection.cancel();
+        player.second.connection->cancel();
 
     request_lock.unlock();
 
+    current_request_lock.lock();
+    current_request_ = nullptr;
+    current_request_lock.unlock();
+
     SessionDataFactory end;
     end.makeEvent(Event::FinishRequest);
-    const io::const_buffer ending_buffer { trunc(end.dataWithLength()) };
+    const Packet ending_data { end.dataWithLength() };
 
-    for (const auto [id, player] : ctx.players) {
+    for (const auto& [id, player] : ctx.players) {
         const auto b { ctx.errorIDs.cbegin() };
         const auto e { ctx.errorIDs.cend() };
 
         if (std::find(b, e, id) == e) {
-            const ErrCode end_err { trySend(player.connection, ending_buffer) };
+            const ErrCode end_err { player.connection->send(ending_data) };
 
             if (end_err) {
                 logPlayerError(id, end_err.message());
@@ -639,6 +770,9 @@ Replies Session::request(const byte targets_id, const Data& data, ReplyControlle
         sendToAll(crash_data.dataWithLength());
     }
 
+    if (sends_held)
+        holdSends(true);
+
     logger_.info("Replies : {}", RepliesWrapper { ctx.replies });
     if (!ctx.errorIDs.empty())
         logger_.warn("Crashed players : {}", ByteVecWrapper { ctx.errorIDs });
@@ -649,7 +783,7 @@ Replies Session::request(const byte targets_id, const Data& data, ReplyControlle
     return ctx.replies;
 }
 
-void Session::sendTo(const byte target_id, const Data& data) {
+void Session::sendTo(const byte target_id, const Packet& data) {
     if (target_id == ALL_PLAYERS) {
         sendToAll(data);
         return;
@@ -660,7 +794,7 @@ void Session::sendTo(const byte target_id, const Data& data) {
         return;
     }
 
-    const ErrCode err { trySend(connection(target_id), trunc(data)) };
+    const ErrCode err { connection(target_id).send(data) };
 
     if (err) {
         logPlayerError(target_id, err.message());
@@ -668,11 +802,9 @@ void Session::sendTo(const byte target_id, const Data& data) {
     }
 }
 
-void Session::sendToAll(const Data& data) {
-    const io::const_buffer buffer { trunc(data) };
-
+void Session::sendToAll(const Packet& data) {
     for (const byte id : ids()) {
-        const ErrCode err { trySend(connection(id), buffer) };
+        const ErrCode err { connection(id).send(data) };
 
         if (err) {
             logPlayerError(id, err.message());
@@ -681,11 +813,31 @@ void Session::sendToAll(const Data& data) {
     }
 }
 
-void Session::sendToAlivePlayers(const Data& data) {
-    const io::const_buffer buffer { trunc(data) };
+void Session::sendToAll(const PacketEncoder& encode) {
+    std::map<Protocol, Packet> encodings;
+
+    for (const byte id : ids()) {
+        auto encoding { encodings.find(protocol(id)) };
+
+        if (encoding == encodings.end()) {
+            SessionDataFactory data_factory;
+            encode(data_factory, protocol(id));
+
+            encoding = encodings.insert({ protocol(id), data_factory.dataWithLength() }).first;
+        }
+
+        const ErrCode err { connection(id).send(encoding->second) };
+
+        if (err) {
+            logPlayerError(id, err.message());
+            disconnect(id, true);
+        }
+    }
+}
 
+void Session::sendToAlivePlayers(const Packet& data) {
     for (const byte id : aliveIDs()) {
-        const ErrCode err { trySend(connection(id), buffer) };
+        const ErrCode err { connection(id).send(data) };
 
         if (err) {
             logPlayerError(id, err.message());
@@ -1,129 +1,241 @@
 ﻿#include <Rbo/SessionDataFactory.hpp>
 
 #include <nlohmann/json.hpp>
+#include <Rbo/Dictionary.hpp>
 #include <Rbo/JsonSerialization.hpp>
 
 namespace Rbo {
 
+namespace {
+
+constexpr byte bit(const UpdateField field) {
+    return static_cast<byte>(field);
+}
+
+constexpr byte bit(const StatField field) {
+    return static_cast<byte>(field);
+}
+
+void putSymbols(Data& data, const Symbols& symbols) {
+    data.putVarint(symbols.count());
+    for (const std::string& name : symbols.names())
+        data.put(name);
+}
+
+// Les limites par défaut sont omises, tout comme la valeur d'une statistique cachée
+void putStat(Data& data, const Stat& stat) {
+    const StatLimits default_limits;
+    const bool visible { !stat.hidden };
+    const bool custom_min { visible && stat.limits.min != default_limits.min };
+    const bool custom_max { visible && stat.limits.max != default_limits.max };
+
+    byte properties { 0 };
+    if (stat.hidden)
+        properties |= bit(StatField::Hidden);
+    if (stat.main)
+        properties |= bit(StatField::Main);
+    if (custom_min)
+        properties |= bit(StatField::Min);
+    if (custom_max)
+        properties |= bit(StatField::Max);
+
+    data.add(properties);
+
+    if (!visible)
+        return;
+
+    data.putSignedVarint(stat.value);
+    if (custom_min)
+        data.putSignedVarint(stat.limits.min);
+    if (custom_max)
+        data.putSignedVarint(stat.limits.max);
+}
+
+// Les identifiants sont triés pour que l'encodage ne dépende pas de l'ordre des tables de hachage
+template<typename Value>
+std::map<word, const Value*> byID(const std::unordered_map<std::string, Value>& named, const Symbols& symbols) {
+    std::map<word, const Value*> sorted;
+    for (const auto& [name, value] : named)
+        sorted.insert({ symbols.id(name), &value });
+
+    return sorted;
+}
+
+}
+
 void SessionDataFactory::makeEvent(const Event event_type) {
-    data_.add(event_type);
+    data_->add(event_type);
 }
 
 void SessionDataFactory::makeStart(const std::string& game_name) {
-    makeEvent(Event::Start);
-    data_.put(game_name);
+    SessionSchema::Start::encode(*data_, game_name);
 }
 
 void SessionDataFactory::makeRequest(const Request type, const byte target) {
     makeEvent(Event::Request);
-    data_.add(type);
-    data_.add(target);
+    data_->add(type);
+    data_->add(target);
 }
 
 void SessionDataFactory::makeRange(const byte target, const std::string& msg, const byte min, const byte max) {
-    makeRequest(Request::Range, target);
-    data_.put(msg);
-    data_.add(min);
-    data_.add(max);
+    SessionSchema::Range::encode(*data_, target, msg, min, max);
 }
 
 void SessionDataFactory::makeOptions(const byte target, const std::string& msg, const OptionsList& options) {
     if (options.size() > OPTIONS_LIMIT)
         throw TooManyOptions { options.size() };
 
-    makeRequest(Request::Options, target);
-    data_.put(msg);
-    data_.putList(options);
+    SessionSchema::Options::encode(*data_, target, msg, options);
 }
 
 void SessionDataFactory::makeYesNoQuestion(const byte target, const std::string& question) {
-    makeRequest(Request::YesNo, target);
-    data_.put(question);
+    SessionSchema::YesNoQuestion::encode(*data_, target, question);
 }
 
 void SessionDataFactory::makeDiceRoll(const byte target, const std::string &msg, const byte dices, const int bonus, const DiceRollResults& results) {
     makeRequest(Request::DiceRoll, target);
-    data_.put(msg);
-    data_.add(dices);
-    data_.putNumeric(bonus);
+    data_->put(msg);
+    data_->add(dices);
+    data_->putNumeric(bonus);
 
-    data_.add(results.size());
+    data_->add(results.size());
     for (const auto& [id, result] : results) {
-        data_.add(id);
+        data_->add(id);
 
         for (const byte dice : result.dices)
-            data_.add(dice);
+            data_->add(dice);
     }
 }
 
 void SessionDataFactory::makeText(const Text txt_type) {
     makeEvent(Event::Text);
-    data_.add(txt_type);
+    data_->add(txt_type);
 }
 
 void SessionDataFactory::makeNormalText(const std::string& txt) {
-    makeText(Text::Normal);
-    data_.put(txt);
+    SessionSchema::NormalText::encode(*data_, txt);
 }
 
 void SessionDataFactory::makeImportantText(const std::string& txt) {
-    makeText(Text::Important);
-    data_.put(txt);
+    SessionSchema::ImportantText::encode(*data_, txt);
 }
 
 void SessionDataFactory::makeTitle(const std::string& title) {
-    makeText(Text::Title);
-    data_.put(title);
+    SessionSchema::Title::encode(*data_, title);
 }
 
 void SessionDataFactory::makeNote(const std::string& note) {
-    makeText(Text::Note);
-    data_.put(note);
+    SessionSchema::Note::encode(*data_, note);
 }
 
 void SessionDataFactory::makePlayerUpdate(const byte id, const PlayerUpdate& changes) {
     // Ce type de constructeur est utilisé car {} ferait appelle à une initializer_list et = à une convertion implicite, ce qui n'est pas souhaitable.
     const json changes_data(changes);
 
+    SessionSchema::JsonPlayerUpdate::encode(*data_, id, changes_data.dump());
+}
+
+void SessionDataFactory::makeDictionary(const Dictionary& dictionary) {
+    makeEvent(Event::Dictionary);
+    putSymbols(*data_, dictionary.globals());
+    putSymbols(*data_, dictionary.stats());
+
+    data_->putVarint(dictionary.inventories().count());
+    for (word inventory { 0 }; inventory < dictionary.inventories().count(); inventory++) {
+        data_->put(dictionary.inventories().names()[inventory]);
+        putSymbols(*data_, dictionary.items(inventory));
+    }
+
+    putSymbols(*data_, dictionary.enemies());
+}
+
+void SessionDataFactory::makePlayerUpdate(const byte id, const PlayerUpdate& changes, const Dictionary& dictionary) {
+    byte fields { 0 };
+    if (changes.death)
+        fields |= bit(UpdateField::Death);
+    if (!changes.stats.empty())
+        fields |= bit(UpdateField::Stats);
+    if (!changes.items.empty())
+        fields |= bit(UpdateField::Items);
+    if (!changes.capacities.empty())
+        fields |= bit(UpdateField::Capacities);
+
     makeEvent(Event::PlayerUpdate);
-    data_.add(id);
+    data_->add(id);
+    data_->add(fields);
+
+    if (changes.death)
+        data_->put(*changes.death);
+
+    if (!changes.stats.empty()) {
+        data_->putVarint(changes.stats.size());
+
+        for (const auto& [stat_id, stat] : byID(changes.stats, dictionary.stats())) {
+            data_->putVarint(stat_id);
+            putStat(*data_, *stat);
+        }
+    }
+
+    if (!changes.items.empty()) {
+        data_->putVarint(changes.items.size());
+
+        for (const auto& [inventory_id, content] : byID(changes.items, dictionary.inventories())) {
+            data_->putVarint(inventory_id);
+            data_->putVarint(content->size());
 
-    data_.put(changes_data.dump());
+            for (const auto& [item_id, qty] : byID(*content, dictionary.items(inventory_id))) {
+                data_->putVarint(item_id);
+                data_->putSignedVarint(*qty);
+            }
+        }
+    }
+
+    if (!changes.capacities.empty()) {
+        data_->putVarint(changes.capacities.size());
+
+        // 0 pour un inventaire illimité, sinon la capacité (toujours positive) décalée de 1
+        for (const auto& [inventory_id, capacity] : byID(changes.capacities, dictionary.inventories())) {
+            data_->putVarint(inventory_id);
+            data_->putVarint(*capacity ? static_cast<ulong>(**capacity) + 1 : 0);
+        }
+    }
 }
 
 void SessionDataFactory::makeGlobalStat(const std::string& name, const Stat& stat) {
     makeEvent(Event::GlobalStat);
-    data_.put(name);
-    data_.add(stat.hidden);
-    data_.add(stat.main);
+    data_->put(name);
+    data_->add(stat.hidden);
+    data_->add(stat.main);
 
     if (stat.hidden)
         return;
 
-    data_.putNumeric(stat.limits.min);
-    data_.putNumeric(stat.limits.max);
-    data_.putNumeric(stat.value);
+    data_->putNumeric(stat.limits.min);
+    data_->putNumeric(stat.limits.max);
+    data_->putNumeric(stat.value);
+}
+
+void SessionDataFactory::makeGlobalStat(const std::string& name, const Stat& stat, const Dictionary& dictionary) {
+    makeEvent(Event::GlobalStat);
+    data_->putVarint(dictionary.global(name));
+    putStat(*data_, stat);
 }
 
 void SessionDataFactory::makeSwitch(const word id) {
-    makeEvent(Event::Switch);
-    data_.putNumeric(id);
+    SessionSchema::Switch::encode(*data_, id);
 }
 
 void SessionDataFactory::makeReply(const byte id, const byte reply) {
-    makeEvent(Event::Reply);
-    data_.add(id);
-    data_.add(reply);
+    SessionSchema::Reply::encode(*data_, id, reply);
 }
 
 void SessionDataFactory::makeValidation(const ReplyValidity reply) {
-    makeEvent(Event::Validation);
-    data_.add(reply);
+    SessionSchema::Validation::encode(*data_, reply);
 }
 
 void SessionDataFactory::makeBattle(const Battle type) {
     makeEvent(Event::Battle);
-    data_.add(type);
+    data_->add(type);
 }
 
 void SessionDataFactory::makeBattleInit(const GroupDescriptor& group, const Game& ctx) {
@@ -138,25 +250,41 @@ void SessionDataFactory::makeBattleInit(const GroupDescriptor& group, const Game
         }));
     }
 
-    makeBattle(Battle::Init);
-    data_.put(infos.dump());
+    SessionSchema::JsonBattleInit::encode(*data_, infos.dump());
 }
 
 void SessionDataFactory::makeBattleAtk(const byte player, const std::string& enemy, const int dmg) {
-    makeBattle(Battle::Atk);
-    data_.add(player);
-    data_.put(enemy);
-    data_.putNumeric(dmg);
+    SessionSchema::BattleAtk::encode(*data_, player, enemy, dmg);
+}
+
+void SessionDataFactory::makeBattleInit(const GroupDescriptor& group, const Game& ctx, const Dictionary& dictionary) {
+    makeBattle(Battle::Init);
+    data_->putVarint(group.size());
+
+    for (const auto& [ctxName, genericName] : group) {
+        const EnemyDescriptor& enemy { ctx.enemy(genericName) };
+
+        data_->put(ctxName);
+        data_->putVarint(dictionary.enemy(genericName));
+        data_->putSignedVarint(enemy.hp);
+        data_->putSignedVarint(enemy.skill);
+    }
+}
+
+void SessionDataFactory::makeBattleAtk(const byte player, const std::string& enemy, const int dmg, const GroupDescriptor& group) {
+    const auto binding { std::find_if(group.cbegin(), group.cend(), [&enemy](const EnemyDescriptorBinding& e) { return e.ctxName == enemy; }) };
+    if (binding == group.cend())
+        throw UnknownSymbol { enemy };
+
+    SessionSchema::BinaryBattleAtk::encode(*data_, player, static_cast<ulong>(std::distance(group.cbegin(), binding)), dmg);
 }
 
 void SessionDataFactory::makeCrash(const byte player) {
-    makeEvent(Event::Crash);
-    data_.add(player);
+    SessionSchema::Crash::encode(*data_, player);
 }
 
 void SessionDataFactory::makeLeaderSwitch(const byte player) {
-    makeEvent(Event::LeaderSwitch);
-    data_.add(player);
+    SessionSchema::LeaderSwitch::encode(*data_, player);
 }
 
 } // namespace Rbo
@@ -0,0 +1,79 @@
+#include <Rbo/Server/GameBundle.hpp>
+
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <sol/sol.hpp>
+
+namespace {
+
+using Rbo::Server::fs::path;
+using Source = Rbo::Server::GameBundle::Source;
+
+// Les données sont seulement converties, leur validité est vérifiée par le serveur au chargement du jeu
+Source convert(const path& game_file) {
+    std::ifstream in { game_file, std::ios::binary };
+    if (!in)
+        throw std::runtime_error { "Unable to open \"" + game_file.string() + '"' };
+
+    try {
+        const std::vector<std::uint8_t> msgpack { nlohmann::json::to_msgpack(nlohmann::json::parse(in)) };
+        return { game_file.filename().string(), std::string { msgpack.cbegin(), msgpack.cend() } };
+    } catch (const nlohmann::json::exception& err) {
+        throw std::runtime_error { "Unable to convert \"" + game_file.string() + "\" : " + err.what() };
+    }
+}
+
+// Seule la compilation est faite, le script n'est pas exécuté et n'a donc besoin d'aucune API du serveur
+Source compile(sol::state& lua, const path& source) {
+    sol::load_result loaded { lua.load_file(source.string()) };
+    if (!loaded.valid()) {
+        const sol::error err { loaded.get<sol::error>() };
+        throw std::runtime_error { "Unable to compile \"" + source.string() + "\" : " + err.what() };
+    }
+
+    const sol::protected_function chunk { loaded.get<sol::protected_function>() };
+    const sol::bytecode bytecode { chunk.dump() };
+
+    return { source.filename().string(), std::string { bytecode.as_string_view() } };
+}
+
+}
+
+int main(const int argc, const char* argv[]) {
+    namespace fs = Rbo::Server::fs;
+
+    constexpr std::string_view usage { "Usage : <game_file> <scenes_file> <instructions_dir> <bundle_file>" };
+
+    if (argc != 5) {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+
+    const fs::path game_file { argv[1] };
+    const fs::path scenes_file { argv[2] };
+    const fs::path instructions_dir { argv[3] };
+    const fs::path bundle_file { argv[4] };
+
+    try {
+        sol::state lua;
+
+        const Source game { convert(game_file) };
+        const Source scenes { compile(lua, scenes_file) };
+
+        std::vector<Source> instructions;
+        for (const fs::directory_entry& entry : fs::directory_iterator { instructions_dir }) {
+            if (fs::is_regular_file(entry) && entry.path().extension() == ".lua")
+                instructions.push_back(compile(lua, entry.path()));
+        }
+
+        const std::size_t scripts_count { instructions.size() + 1 };
+        Rbo::Server::GameBundle::write(bundle_file, game, scenes, std::move(instructions));
+
+        std::cout << "Bundled game and " << scripts_count << " scripts into " << bundle_file << std::endl;
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <Rbo/CheckpointStore.hpp>
+
+#include <Rbo/JsonSerialization.hpp>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+using Rbo::CheckpointEncoding;
+using Rbo::CheckpointStore;
+using Rbo::json;
+
+CheckpointEncoding parseEncoding(const std::string& name) {
+    if (name == "json")
+        return CheckpointEncoding::Json;
+    else if (name == "cbor")
+        return CheckpointEncoding::Cbor;
+    else if (name == "msgpack")
+        return CheckpointEncoding::MessagePack;
+    else
+        throw std::invalid_argument { "Unknown encoding \"" + name + '"' };
+}
+
+// Le journal serait sinon créé vide à l'ouverture
+void requireStore(const fs::path& store_file) {
+    if (!fs::exists(store_file))
+        throw std::runtime_error { "No checkpoint store \"" + store_file.string() + '"' };
+}
+
+// Journal créé à côté de la destination, qui ne doit la remplacer qu'une fois complet
+template<typename Fill>
+fs::path createStore(const fs::path& store_file, const CheckpointEncoding encoding, Fill&& fill) {
+    const fs::path created { store_file.string() + ".new" };
+    fs::remove(created);
+
+    CheckpointStore store { created, encoding };
+    fill(store);
+    store.sync();
+
+    return created;
+}
+
+// Fichier JSON des checkpoints, comme ceux enregistrés avant le journal
+void importJson(const fs::path& json_file, const fs::path& store_file, const CheckpointEncoding encoding) {
+    std::ifstream in { json_file };
+    const json data = json::parse(in);
+
+    const fs::path created { createStore(store_file, encoding, [&data](CheckpointStore& store) {
+        for (const auto& [name, chkpt] : data.items())
+            store.save(name, chkpt.get<Rbo::GameState>());
+    }) };
+
+    fs::rename(created, store_file);
+
+    std::cout << "Imported " << data.size() << " checkpoints into " << store_file << std::endl;
+}
+
+void exportJson(const fs::path& store_file, const fs::path& json_file) {
+    requireStore(store_file);
+    const CheckpointStore store { store_file };
+
+    json data = json::object();
+    for (const std::string& name : store.names())
+        data[name] = store.load(name);
+
+    std::ofstream out { json_file };
+    out << data.dump(4);
+
+    if (!out)
+        throw std::runtime_error { "Unable to write \"" + json_file.string() + '"' };
+
+    std::cout << "Exported " << store.count() << " checkpoints into " << json_file << std::endl;
+}
+
+void convert(const fs::path& store_file, const CheckpointEncoding encoding) {
+    requireStore(store_file);
+
+    std::size_t count;
+    fs::path created;
+    {
+        const CheckpointStore source { store_file };
+        count = source.count();
+
+        created = createStore(store_file, encoding, [&source](CheckpointStore& store) {
+            for (const std::string& name : source.names())
+                store.save(name, source.load(name));
+        });
+    }
+
+    // Le journal d'origine doit être fermé pour être remplacé
+    fs::rename(created, store_file);
+
+    std::cout << "Converted " << count << " checkpoints of " << store_file << std::endl;
+}
+
+}
+
+int main(const int argc, const char* argv[]) {
+    constexpr std::string_view usage {
+        "Usage : import <json_file> <store_file> [json|cbor|msgpack]\n"
+        "        export <store_file> <json_file>\n"
+        "        convert <store_file> <json|cbor|msgpack>"
+    };
+
+    const std::string command { argc >= 2 ? argv[1] : "" };
+    const bool valid_args {
+        (command == "import" && (argc == 4 || argc == 5))
+        || (command == "export" && argc == 4)
+        || (command == "convert" && argc == 4)
+    };
+
+    if (!valid_args) {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+
+    try {
+        if (command == "import")
+            importJson(argv[2], argv[3], argc == 5 ? parseEncoding(argv[4]) : CheckpointEncoding::Json);
+        else if (command == "export")
+            exportJson(argv[2], argv[3]);
+        else
+            convert(argv[2], parseEncoding(argv[3]));
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
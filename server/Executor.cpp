@@ -2,48 +2,68 @@
 
 namespace Rbo::Server {
 
-Executor::Executor(io::io_context& server, Lobby& lobby, spdlog::logger& logger)
+Executor::Executor(io::io_context& server, std::list<Lobby>& lobbies, spdlog::logger& logger, const std::size_t events_threads, const SessionsMode mode)
     : logger_ { logger },
       server_ { server },
-      lobby_ { lobby },
+      events_threads_ { std::max<std::size_t>(events_threads, 1) },
+      mode_ { mode },
+      running_lobbies_ { 0 },
       state_ { Stopped },
-      stop_handler_done_ { false } {}
+      stop_handler_done_ { false },
+      running_events_loops_ { 0 }
+{
+    for (Lobby& lobby : lobbies)
+        lobbies_.emplace_back(lobby);
+}
 
 void Executor::stop(const State stopped_reason, const std::string_view err_msg) {
     assert(stopped_reason != Running);
 
-    state_ = stopped_reason;
-    server_.stop();
-
-    lobby_.requestClosure();
+    // Plusieurs threads de lobby ou d'événements peuvent demander l'arrêt en même temps, seul le premier est traité
+    State expected_state { Running };
+    if (!state_.compare_exchange_strong(expected_state, stopped_reason)) {
+        if (!err_msg.empty())
+            logger_.error(err_msg);
 
-    std::unique_lock session_lock { session_mtx_ };
-    if (session_)
-        session_->stop();
-    session_lock.unlock();
+        return;
+    }
 
-    const bool is_reason_error { hasError() };
+    // Le contexte d'E/S continue de tourner : les lobbies doivent encore pouvoir se fermer, et leurs notifications être écrites
+    for (HostedLobby& hosted : lobbies_) {
+        hosted.lobby.requestClosure();
 
-    std::unique_lock lobby_lock { lobby_mtx_ };
-    lobby_.close(is_reason_error);
-    lobby_lock.unlock();
+        std::unique_lock session_lock { hosted.sessionMtx };
+        if (hosted.session)
+            hosted.session->stop();
+        session_lock.unlock();
+    }
 
-    if (is_reason_error)
+    // Chaque lobby est fermé par son propre thread ou sa propre coroutine, qui ne sont plus bloqués par aucune attente
+    if (hasError())
         logger_.critical(err_msg);
 
+    std::unique_lock stop_lock { stop_mtx_ };
     stop_handler_done_ = true;
+    stop_lock.unlock();
+
+    stop_handler_cv_.notify_all();
 }
 
 void Executor::runEventsLoop() {
     logger_.debug("<-- Running events loop on this thread.");
 
-    while (isRunning()) {
+    while (!server_.stopped()) {
         try {
             server_.run();
         } catch (const std::exception& err) {
             stop(EventsLoopError, err.what());
         }
     }
+
+    const std::lock_guard stop_lock { stop_mtx_ };
+    running_events_loops_--;
+
+    stop_handler_cv_.notify_all();
 }
 
 } // namespace Rbo::Server
@@ -0,0 +1,109 @@
+#include <Rbo/Server/GameBundle.hpp>
+
+#include <fstream>
+#include <Rbo/Data.hpp>
+
+namespace Rbo::Server {
+
+namespace ipc = boost::interprocess;
+
+namespace {
+
+template<typename Length>
+void writeBlock(std::ofstream& out, const std::string& block) {
+    std::array<byte, sizeof(Length)> length;
+    writeBigEndian(static_cast<Length>(block.length()), length.data());
+
+    out.write(reinterpret_cast<const char*>(length.data()), length.size());
+    out.write(block.data(), static_cast<std::streamsize>(block.length()));
+}
+
+template<typename Length>
+std::string_view readBlock(DataReader& reader) {
+    const Length length { reader.getNumeric<Length>() };
+    return { reinterpret_cast<const char*>(reader.getBytes(length)), length };
+}
+
+void writeSection(std::ofstream& out, const GameBundle::Source& section) {
+    writeBlock<word>(out, section.name);
+    writeBlock<uint>(out, section.content);
+}
+
+GameBundle::Section readSection(DataReader& reader) {
+    GameBundle::Section section;
+    section.name = readBlock<word>(reader);
+    section.content = readBlock<uint>(reader);
+
+    return section;
+}
+
+}
+
+GameBundle::GameBundle(const fs::path& bundle) {
+    try {
+        file_ = ipc::file_mapping { bundle.string().c_str(), ipc::read_only };
+        region_ = ipc::mapped_region { file_, ipc::read_only };
+    } catch (const ipc::interprocess_exception& err) {
+        throw BundleError { bundle, std::string { "unable to map : " } + err.what() };
+    }
+
+    DataReader reader { static_cast<const byte*>(region_.get_address()), region_.get_size() };
+    try {
+        const byte* const magic { reader.getBytes(MAGIC.size()) };
+        if (!std::equal(MAGIC.cbegin(), MAGIC.cend(), magic))
+            throw BundleError { bundle, "not a game bundle" };
+
+        const byte version { reader.get() };
+        if (version != FORMAT_VERSION)
+            throw BundleError { bundle, "unsupported format version " + std::to_string(version) };
+
+        instructions_.resize(reader.getNumeric<word>());
+
+        game_ = readSection(reader);
+        scenes_ = readSection(reader);
+        for (Section& script : instructions_)
+            script = readSection(reader);
+    } catch (const MalformedData& err) {
+        throw BundleError { bundle, std::string { "truncated, " } + err.what() };
+    }
+}
+
+void GameBundle::write(const fs::path& bundle, const Source& game, const Source& scenes, std::vector<Source> instructions) {
+    std::sort(instructions.begin(), instructions.end(), [](const Source& lhs, const Source& rhs) { return lhs.name < rhs.name; });
+
+    // Un serveur peut avoir projeté le bundle en mémoire : il n'est jamais réécrit en place, mais remplacé une fois complet
+    const fs::path written { bundle.string() + ".tmp" };
+    {
+        std::ofstream out { written, std::ios::binary | std::ios::trunc };
+
+        std::array<byte, 1 + sizeof(word)> header { FORMAT_VERSION };
+        writeBigEndian(static_cast<word>(instructions.size()), header.data() + 1);
+
+        out.write(MAGIC.data(), MAGIC.size());
+        out.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+        writeSection(out, game);
+        writeSection(out, scenes);
+        for (const Source& script : instructions)
+            writeSection(out, script);
+
+        out.close();
+        if (!out) {
+            std::error_code ignored;
+            fs::remove(written, ignored);
+
+            throw BundleError { bundle, "unable to write" };
+        }
+    }
+
+    std::error_code fs_err;
+    fs::rename(written, bundle, fs_err);
+    if (fs_err) {
+        std::error_code ignored;
+        fs::remove(written, ignored);
+
+        throw BundleError { bundle, "unable to replace : " + fs_err.message() };
+    }
+}
+
+} // namespace Rbo::Server
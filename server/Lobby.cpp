@@ -16,14 +16,63 @@ std::size_t Lobby::RemoteEndpointHash::operator()(const tcp::endpoint& client) c
     return std::hash<std::string> {} (str.str());
 }
 
+std::size_t Lobby::counter_ { 0 };
+
+// Les handlers d'un même lobby passent par son strand : plusieurs threads peuvent faire tourner le contexte d'E/S partagé
 Lobby::Lobby(io::io_context& lobby_io, tcp::endpoint acceptor_endpt, const ulong preparation_countdown_ms)
     : prepare_delay_ {preparation_countdown_ms },
       acceptor_endpt_ { std::move(acceptor_endpt) },
-      logger_ { rboLogger("Lobby") },
-      new_players_acceptor_ { lobby_io },
+      logger_ { rboLogger("Lobby-" + std::to_string(counter_++)) },
+      strand_ { io::make_strand(lobby_io) },
+      new_players_acceptor_ { strand_ },
       closure_requested_ { false },
       state_ { Idle },
-      prepare_timer_ { lobby_io } {}
+      prepare_timer_ { strand_ } {}
+
+void Lobby::setState(const State state) {
+    const std::lock_guard state_lock { state_mtx_ };
+    state_ = state;
+
+    state_changed_.notify();
+}
+
+template<typename Work>
+void Lobby::onStrand(Work&& work) {
+    // En mode coroutines, le lobby s'exécute déjà sur son strand
+    if (strand_.running_in_this_thread()) {
+        work();
+        return;
+    }
+
+    std::packaged_task<void()> task { std::forward<Work>(work) };
+    std::future<void> done { task.get_future() };
+
+    io::post(strand_, [&task]() { task(); });
+    done.get();
+}
+
+void Lobby::waitPreparation(const OptionalCoroutine& coroutine) {
+    std::unique_lock state_lock { state_mtx_ };
+    state_changed_.wait(state_lock, [this]() { return !(isOpen() || isStarting()) || closure_requested_; }, coroutine);
+}
+
+void Lobby::requestClosure() {
+    const std::lock_guard state_lock { state_mtx_ };
+    closure_requested_ = true;
+
+    state_changed_.notify();
+
+    // La réception en attente d'une réponse du master est interrompue, elle n'aboutirait sinon qu'à la fermeture du lobby
+    // Pendant la partie, les connexions appartiennent à la Session et ne sont plus dans connections_
+    io::post(strand_, [this]() {
+        if (!isPreparing() || !master_)
+            return;
+
+        const auto master_connection { connections_.find(*master_) };
+        if (master_connection != connections_.cend() && master_connection->second)
+            master_connection->second->cancel();
+    });
+}
 
 void Lobby::logMemberError(const byte id, const ErrCode& err) {
     logger_.error("Member {} : {}", id, err.message());
@@ -34,7 +83,7 @@ void Lobby::logRegisteringError(const tcp::endpoint& client, const ErrCode& err)
 }
 
 void Lobby::disconnect(const byte id, const bool crash) {
-    tcp::socket& client { connections_.at(id) };
+    tcp::socket& client { connections_.at(id)->socket() };
     try {
         logger_.info("Member {} disconnected ({}). Crash = {}", id, client.remote_endpoint(), crash);
     } catch (const boost::system::system_error& err) {
@@ -42,7 +91,7 @@ void Lobby::disconnect(const byte id, const bool crash) {
     }
 
     if (!crash)
-        connections_.at(id).shutdown(tcp::socket::shutdown_both);
+        connections_.at(id)->shutdown();
 
     members_.erase(id);
     connections_.erase(id);
@@ -65,10 +114,9 @@ void Lobby::disconnect(const byte id, const bool crash) {
     sendToAll(disconnect_data.dataWithLength());
 }
 
-void Lobby::sendToAll(const Data& data) {
-    const io::const_buffer buffer { trunc(data) };
+void Lobby::sendToAll(const Packet& data) {
     for (const byte id : ids()) {
-        const ErrCode send_err { trySend(connections_.at(id), buffer) };
+        const ErrCode send_err { connections_.at(id)->send(data) };
 
         if (send_err) {
             logger_.error("Sending failed for {} : {}", id, send_err.message());
@@ -103,11 +151,11 @@ bool Lobby::ready(const byte id) const {
 void Lobby::beginCountdown() {
     logger_.info("Session preparation into {} ms...", prepare_delay_.count());
 
-    state_ = Starting;
+    setState(Starting);
     prepare_timer_.expires_after(prepare_delay_);
     prepare_timer_.async_wait([this](const ErrCode err) {
         if (err) {
-            if (!(err == io::error::basic_errors::operation_aborted && isOpen())) {
+            if (!(err == io::error::basic_errors::operation_aborted && (isOpen() || isClosed()))) {
                 cancelCountdown(true);
                 logger_.error("Unexpected preparation cancellation : {}", err.message());
             }
@@ -115,11 +163,12 @@ void Lobby::beginCountdown() {
             return;
         }
 
-        state_ = Preparing;
-
         new_players_acceptor_.close();
         for (auto& connection : connections_)
-            connection.second.cancel();
+            connection.second->cancel();
+
+        // L'Executor est réveillé dès ce changement d'état, les écoutes doivent donc déjà être annulées
+        setState(Preparing);
     });
 
     LobbyDataFactory preparation_data;
@@ -129,7 +178,7 @@ void Lobby::beginCountdown() {
 }
 
 void Lobby::cancelCountdown(const bool is_crash) {
-    state_ = Open;
+    setState(Open);
     if (!is_crash)
         prepare_timer_.cancel();
 
@@ -143,36 +192,53 @@ void Lobby::cancelCountdown(const bool is_crash) {
 
 void Lobby::open() {
     logger_.info("Opening on port {}.", port());
-    state_ = Open;
 
-    new_players_acceptor_.open(acceptor_endpt_.protocol());
-    new_players_acceptor_.set_option(tcp::acceptor::reuse_address { true });
-    new_players_acceptor_.bind(acceptor_endpt_);
-    new_players_acceptor_.listen();
+    onStrand([this]() {
+        setState(Open);
 
-    LobbyDataFactory open_data;
-    open_data.makeEvent(Event::Open);
+        new_players_acceptor_.open(acceptor_endpt_.protocol());
+        new_players_acceptor_.set_option(tcp::acceptor::reuse_address { true });
+        new_players_acceptor_.bind(acceptor_endpt_);
+        new_players_acceptor_.listen();
 
-    sendToAll(open_data.dataWithLength());
+        LobbyDataFactory open_data;
+        open_data.makeEvent(Event::Open);
 
-    master_.reset();
-    updateMaster();
+        sendToAll(open_data.dataWithLength());
 
-    acceptMember();
-    logger_.info("Opened.");
+        master_.reset();
+        updateMaster();
 
-    for (auto& connection : connections_)
-        listenMember(connection.first);
+        acceptMember();
+
+        for (auto& connection : connections_)
+            listenMember(connection.first);
+    });
+
+    logger_.info("Opened.");
 }
 
 void Lobby::close(const bool crash) {
     logger_.info("Closing...");
-    state_ = Closed;
 
-    if (!crash) {
-        for (const byte id : ids())
-            disconnect(id);
-    }
+    onStrand([this, crash]() {
+        setState(Closed);
+
+        // Plus aucune opération ne doit rester en attente, le contexte d'E/S s'arrête une fois les dernières écritures terminées
+        ErrCode close_err;
+        new_players_acceptor_.close(close_err);
+        prepare_timer_.cancel();
+
+        for (auto& [endpt, connection] : registering_)
+            connection->shutdown();
+
+        registering_.clear();
+
+        if (!crash) {
+            for (const byte id : ids())
+                disconnect(id);
+        }
+    });
 
     logger_.info("Closed.");
 }
@@ -186,13 +252,13 @@ void Lobby::acceptMember() {
 
 void Lobby::listenMember(const byte id) {
     logger_.debug("Listening requests of [{}]...", id);
-    connections_.at(id).async_receive(io::buffer(request_buffers_.at(id)), [this, id](const ErrCode err, const std::size_t len) {
-        handleMemberRequest(id, err, len);
+    connections_.at(id)->receive(FrameType::Byte, [this, id](const ErrCode err, const ReceiveBuffer& request, const std::size_t) {
+        handleMemberRequest(id, err, request);
     });
 }
 
 void Lobby::registerMember(const ErrCode accept_err, tcp::socket connection) {
-    if (accept_err == io::error::basic_errors::operation_aborted && isPreparing()) {
+    if ((accept_err == io::error::basic_errors::operation_aborted && isPreparing()) || isClosed()) {
         logger_.debug("Registration cancelled.");
         return;
     }
@@ -206,22 +272,24 @@ void Lobby::registerMember(const ErrCode accept_err, tcp::socket connection) {
     }
 
     logger_.info("Connection established from {}.", client_endpt);
-    registering_.insert({ connection.remote_endpoint(), std::move(connection) });
-    registering_buffers_.insert({ client_endpt, ReceiveBuffer {} });
-    registering_buffers_.at(client_endpt).fill(0);
+    registering_.insert({ client_endpt, std::make_shared<Connection>(std::move(connection)) });
 
-    registering_.at(client_endpt).async_receive(io::buffer(registering_buffers_.at(client_endpt)), [this, client_endpt](const ErrCode name_err, const std::size_t) {
-        handleRegistrationRequest(client_endpt, name_err);
+    registering_.at(client_endpt)->receive(FrameType::IdentifiedString, [this, client_endpt](const ErrCode name_err, const ReceiveBuffer& id_name, const std::size_t) {
+        handleRegistrationRequest(client_endpt, name_err, id_name);
     });
 }
 
-void Lobby::handleRegistrationRequest(const tcp::endpoint& client_endpt, const ErrCode& name_err) {
+void Lobby::handleRegistrationRequest(const tcp::endpoint& client_endpt, const ErrCode& name_err, const ReceiveBuffer& id_name_buffer) {
+    if (isClosed()) {
+        logger_.debug("Registration of {} cancelled.", client_endpt);
+        return;
+    }
+
     if (name_err) {
         logRegisteringError(client_endpt, name_err);
         return;
     }
 
-    const ReceiveBuffer& id_name_buffer {registering_buffers_.at(client_endpt) };
     const byte id { id_name_buffer.at(0) };
 
     std::string name;
@@ -246,7 +314,7 @@ void Lobby::handleRegistrationRequest(const tcp::endpoint& client_endpt, const E
     else
         registration_data.makeRegistration(registration);
 
-    const ErrCode send_register_err { trySend(registering_.at(client_endpt), trunc(registration_data.dataWithLength())) };
+    const ErrCode send_register_err { registering_.at(client_endpt)->send(registration_data.dataWithLength()) };
 
     if (send_register_err) {
         logRegisteringError(client_endpt, send_register_err);
@@ -255,7 +323,7 @@ void Lobby::handleRegistrationRequest(const tcp::endpoint& client_endpt, const E
 
     if (registration != RegistrationResult::Ok) {
         logger_.warn("Unable to register [{}] : #{}", client_endpt, static_cast<int>(registration));
-        registering_.at(client_endpt).shutdown(tcp::socket::shutdown_both);
+        registering_.at(client_endpt)->shutdown();
         registering_.erase(client_endpt);
 
         return;
@@ -267,14 +335,10 @@ void Lobby::handleRegistrationRequest(const tcp::endpoint& client_endpt, const E
 
     sendToAll(new_player_data.dataWithLength());
 
-    members_.insert({id, Member {name, false } });
+    members_.insert({id, Member {name, false, Protocol::Json } });
     connections_.insert({id, std::move(registering_.at(client_endpt)) });
 
-    request_buffers_.insert({id, ReceiveBuffer {} });
-    request_buffers_.at(id).fill(0);
-
     registering_.erase(client_endpt);
-    registering_buffers_.erase(client_endpt);
 
     if (!updateMaster())
         sendMaster();
@@ -282,12 +346,14 @@ void Lobby::handleRegistrationRequest(const tcp::endpoint& client_endpt, const E
     listenMember(id);
 }
 
+// Protocol est suivi de la dernière version comprise par le client, Compression de la dernière compression qu'il sait décompresser.
+// Les anciens clients n'envoient jamais ni l'une ni l'autre.
 enum struct MemberRequest : byte {
-    Ready, Disconnect
+    Ready, Disconnect, Protocol, Compression
 };
 
-void Lobby::handleMemberRequest(const byte id, const ErrCode request_err, const std::size_t request_len) {
-    if (request_err == io::error::basic_errors::operation_aborted && isPreparing()) {
+void Lobby::handleMemberRequest(const byte id, const ErrCode request_err, const ReceiveBuffer& request_buffer) {
+    if ((request_err == io::error::basic_errors::operation_aborted && isPreparing()) || isClosed()) {
         logger_.debug("Listening to requests canceled for [{}].", id);
         return;
     }
@@ -298,8 +364,7 @@ void Lobby::handleMemberRequest(const byte id, const ErrCode request_err, const
         return;
     }
 
-    ReceiveBuffer& request_buffer { request_buffers_.at(id) };
-    if (request_len != 1 || request_buffer[0] > static_cast<byte>(MemberRequest::Disconnect)) {
+    if (request_buffer[0] > static_cast<byte>(MemberRequest::Compression)) {
         disconnect(id, true);
         logger_.error("Member {} : Invalid request.", id);
         return;
@@ -336,48 +401,138 @@ void Lobby::handleMemberRequest(const byte id, const ErrCode request_err, const
         break;
     } case MemberRequest::Disconnect:
         disconnect(id);
+        return;
+    case MemberRequest::Protocol:
+        connections_.at(id)->receive(FrameType::Byte, [this, id](const ErrCode err, const ReceiveBuffer& version, const std::size_t) {
+            handleProtocolRequest(id, err, version);
+        });
+
+        return;
+    case MemberRequest::Compression:
+        connections_.at(id)->receive(FrameType::Byte, [this, id](const ErrCode err, const ReceiveBuffer& compression, const std::size_t) {
+            handleCompressionRequest(id, err, compression);
+        });
+
         return;
     }
 
-    request_buffer.fill(0);
     listenMember(id);
 }
 
-void Lobby::safeSendToAll(const Data& data) {
-    const bool was_here { master_ };
-    const std::optional<byte> prev_master { master_ };
+void Lobby::handleProtocolRequest(const byte id, const ErrCode version_err, const ReceiveBuffer& version_buffer) {
+    if ((version_err == io::error::basic_errors::operation_aborted && isPreparing()) || isClosed()) {
+        logger_.debug("Listening to requests canceled for [{}].", id);
+        return;
+    }
 
-    sendToAll(data);
+    if (version_err) {
+        disconnect(id, true);
+        logMemberError(id, version_err);
+        return;
+    }
+
+    // Un client plus récent que le serveur se contente de la dernière version connue de celui-ci
+    const auto protocol { static_cast<Protocol>(std::min(version_buffer[0], static_cast<byte>(LATEST_PROTOCOL))) };
+    members_.at(id).protocol = protocol;
+
+    logger_.info("Member \"{}\" [{}] uses protocol {}.", name(id), id, static_cast<int>(protocol));
 
-    if (was_here && (!master_ || *prev_master != master_ ))
-        throw MasterDisconnected { *prev_master };
+    LobbyDataFactory protocol_data;
+    protocol_data.makeProtocol(protocol);
+
+    const ErrCode send_err { connections_.at(id)->send(protocol_data.dataWithLength()) };
+    if (send_err) {
+        disconnect(id, true);
+        logMemberError(id, send_err);
+        return;
+    }
+
+    listenMember(id);
 }
 
-ReceiveBuffer Lobby::receiveFromMaster() {
-    ReceiveBuffer buffer;
-    buffer.fill(0);
+void Lobby::handleCompressionRequest(const byte id, const ErrCode compression_err, const ReceiveBuffer& compression_buffer) {
+    if ((compression_err == io::error::basic_errors::operation_aborted && isPreparing()) || isClosed()) {
+        logger_.debug("Listening to requests canceled for [{}].", id);
+        return;
+    }
 
-    std::atomic_bool received { false };
-    bool receive_err { false };
+    if (compression_err) {
+        disconnect(id, true);
+        logMemberError(id, compression_err);
+        return;
+    }
+
+    const auto compression { static_cast<Compression>(std::min(compression_buffer[0], static_cast<byte>(LATEST_COMPRESSION))) };
+
+    logger_.info("Member \"{}\" [{}] uses compression {}.", name(id), id, static_cast<int>(compression));
+
+    LobbyDataFactory compression_data;
+    compression_data.makeCompression(compression);
 
-    connections_.at(*master_).async_receive(io::buffer(buffer), [&received, &receive_err](const ErrCode err, const std::size_t) {
-        received = true;
+    // La réponse n'est pas compressée, le client ne remet son flux à zéro qu'après l'avoir reçue
+    const ErrCode send_err { connections_.at(id)->send(compression_data.dataWithLength()) };
+    if (send_err) {
+        disconnect(id, true);
+        logMemberError(id, send_err);
+        return;
+    }
 
-        if (err)
-            receive_err = true;
+    connections_.at(id)->compress(compression);
+
+    listenMember(id);
+}
+
+void Lobby::safeSendToAll(const Packet& data) {
+    onStrand([this, &data]() {
+        const bool was_here { master_ };
+        const std::optional<byte> prev_master { master_ };
+
+        sendToAll(data);
+
+        if (was_here && (!master_ || *prev_master != master_ ))
+            throw MasterDisconnected { *prev_master };
+    });
+}
+
+ReceiveBuffer Lobby::receiveFromMaster(const FrameType reply_type) {
+    // Une demande de fermeture interrompt l'attente avant le handler de réception, l'état de celle-ci lui est donc partagé
+    struct MasterReply {
+        ReceiveBuffer buffer;
+        bool received { false };
+        ErrCode err;
+    };
+
+    const std::shared_ptr<MasterReply> reply { std::make_shared<MasterReply>() };
+    reply->buffer.fill(0);
+
+    onStrand([this, reply_type, reply]() {
+        connections_.at(*master_)->receive(reply_type, [this, reply](const ErrCode err, const ReceiveBuffer& frame, const std::size_t) {
+            const std::lock_guard state_lock { state_mtx_ };
+            reply->buffer = frame;
+            reply->received = true;
+            reply->err = err;
+
+            state_changed_.notify();
+        });
     });
 
-    while (!received && !closure_requested_)
-        std::this_thread::sleep_for(std::chrono::milliseconds { 1 });
+    std::unique_lock state_lock { state_mtx_ };
+    state_changed_.wait(state_lock, [this, &reply]() { return reply->received || closure_requested_; }, coroutine_);
+
+    const ReceiveBuffer buffer { reply->buffer };
+    const bool receive_err { reply->received && reply->err };
+    const bool aborted { reply->err == io::error::basic_errors::operation_aborted };
+    state_lock.unlock();
 
-    if (receive_err)
+    if (receive_err && !(aborted && closure_requested_))
         disconnectMaster();
 
     return buffer;
 }
 
-void Lobby::sendToMaster(const Data& data) {
-    const ErrCode send_err { trySend(connections_.at(*master_), trunc(data)) };
+void Lobby::sendToMaster(const Packet& data) {
+    ErrCode send_err;
+    onStrand([this, &data, &send_err]() { send_err = connections_.at(*master_)->send(data); });
 
     if (send_err)
         disconnectMaster();
@@ -416,9 +571,10 @@ void Lobby::sendMaster() {
 void Lobby::disconnectMaster() {
     assert(master_.has_value());
 
-    disconnect(*master_, true);
+    const byte master { *master_ };
+    onStrand([this, master]() { disconnect(master, true); });
 
-    throw MasterDisconnected { *master_ };
+    throw MasterDisconnected { master };
 }
 
 std::string Lobby::askCheckpoint() {
@@ -428,7 +584,7 @@ std::string Lobby::askCheckpoint() {
     logger_.info("Asking master [{}] for checkpoint...", *master_);
     sendToMaster(ask_data.dataWithLength());
 
-    const ReceiveBuffer chkpt_buffer { receiveFromMaster() };
+    const ReceiveBuffer chkpt_buffer { receiveFromMaster(FrameType::String) };
 
     std::string chkpt_name;
     if (closure_requested_) {
@@ -450,7 +606,7 @@ bool Lobby::askYesNo(const YesNoQuestion request) {
     logger_.info("Asking master [{}] for #{}...", *master_, static_cast<int>(request));
     sendToMaster(ask_data.dataWithLength());
 
-    const ReceiveBuffer reply { receiveFromMaster() };
+    const ReceiveBuffer reply { receiveFromMaster(FrameType::Byte) };
 
     if (closure_requested_)
         logger_.info("Closure requested, master's reply ignored.");
@@ -462,15 +618,21 @@ bool Lobby::askYesNo(const YesNoQuestion request) {
 
 void Lobby::reset() {
     logger_.info("Resetting state to idle...");
-    state_ = Idle;
+    onStrand([this]() {
+        setState(Idle);
 
-    for (auto& member : members_)
-        member.second.ready = false;
+        for (auto& member : members_)
+            member.second.ready = false;
+    });
 
     logger_.info("Reset.");
 }
 
 void Lobby::prepareSession(Session& session) {
+    coroutine_.reset();
+    if (session.coroutine())
+        coroutine_.emplace(*session.coroutine());
+
     try {
         LobbyDataFactory prepare_data;
         prepare_data.makePrepare(*master_);
@@ -482,18 +644,21 @@ void Lobby::prepareSession(Session& session) {
     } catch (const MasterDisconnected& err) {
         logger_.error(err.what());
 
-        LobbyDataFactory master_dc_data;
-        master_dc_data.makeEvent(Event::MasterDisconnected);
+        onStrand([this]() {
+            LobbyDataFactory master_dc_data;
+            master_dc_data.makeEvent(Event::MasterDisconnected);
 
-        sendToAll(master_dc_data.dataWithLength());
+            sendToAll(master_dc_data.dataWithLength());
 
-        for (auto& member : members_)
-            member.second.ready = false;
+            for (auto& member : members_)
+                member.second.ready = false;
+        });
     } catch (const NoPlayerRemaining& err) {
         logger_.error(err.what());
     }
 
-    state_ = Idle;
+    coroutine_.reset();
+    setState(Idle);
 }
 
 void Lobby::configureSession(Session& session, const std::optional<std::string>& chkpt_name, std::optional<bool> missing_entrants) {
@@ -526,15 +691,18 @@ void Lobby::configureSession(Session& session, const std::optional<std::string>&
     }
 
     Run run { runSession(session, requested_chkpt, *missing_entrants) };
-    members_.clear();
-    connections_.clear();
 
     logger_.trace("Sending session's result to entrants...");
 
-    for (auto& [id, entrant] : run.entrants) {
-        members_.insert({ id, Member {entrant.name, false } });
-        connections_.insert({ id, std::move(entrant.socket) });
-    }
+    onStrand([this, &run]() {
+        members_.clear();
+        connections_.clear();
+
+        for (auto& [id, entrant] : run.entrants) {
+            members_.insert({ id, Member {entrant.name, false, entrant.protocol } });
+            connections_.insert({ id, std::move(entrant.connection) });
+        }
+    });
 
     LobbyDataFactory run_data;
     if (isInvalidIDs(run.result))
@@ -580,15 +748,19 @@ void Lobby::configureSession(Session& session, const std::optional<std::string>&
             const auto& e { run.expectedIDs.cend() };
 
             if (std::find(b, e, master_) == e) {
-                disconnect(*master_);
-                throw MasterDisconnected { *master_ };
-            }
+                const byte master { *master_ };
+                onStrand([this, master]() { disconnect(master); });
 
-            for (const byte id : ids()) {
-                if (std::find(b, e, id) == e)
-                    disconnect(id);
+                throw MasterDisconnected { master };
             }
 
+            onStrand([this, b, e]() {
+                for (const byte id : ids()) {
+                    if (std::find(b, e, id) == e)
+                        disconnect(id);
+                }
+            });
+
             session.reset();
             configureSession(session, chkpt_name);
         } else if (askYesNo(YesNoQuestion::RetryCheckpoint)) {
@@ -616,8 +788,16 @@ Run Lobby::runSession(Session& session, const std::string& chkpt_name, const boo
     safeSendToAll(start_data.dataWithLength());
 
     Entrants entrants;
-    for (const auto& [id, member] : members())
-        entrants.insert({ id, Entrant { member.name, std::move(connections_.at(id)) } });
+    onStrand([this, &entrants]() {
+        // Les requêtes de lobby encore en attente ne doivent pas être lues comme les premières réponses de la partie
+        for (const auto& [id, member] : members()) {
+            connections_.at(id)->discardReceived();
+            entrants.insert({ id, Entrant { member.name, std::move(connections_.at(id)), member.protocol } });
+        }
+
+        // Les connexions sont rendues au lobby avec le résultat de la partie
+        connections_.clear();
+    });
 
     try {
         session.start(entrants, chkpt_name, missing_entrants);
@@ -3,84 +3,75 @@
 namespace Rbo::Server {
 
 void LobbyDataFactory::makeRegistration(const RegistrationResult result) {
-    data_.add(result);
+    LobbySchema::Registration::encode(*data_, result);
 }
 
 void LobbyDataFactory::makeEvent(const Event event) {
-    data_.add(event);
+    data_->add(event);
 }
 
 void LobbyDataFactory::makePreparing(const ulong delay) {
-    makeEvent(Event::BeginCountdown);
-    data_.putNumeric(delay);
+    LobbySchema::Preparing::encode(*data_, delay);
 }
 
 void LobbyDataFactory::makeNewMember(const byte id, const std::string& name) {
-    makeEvent(Event::MemberRegistered);
-    data_.add(id);
-    data_.put(name);
+    LobbySchema::NewMember::encode(*data_, id, name);
 }
 
 void LobbyDataFactory::makeReady(const byte id) {
-    makeEvent(Event::MemberReady);
-    data_.add(id);
+    LobbySchema::Ready::encode(*data_, id);
 }
 
 void LobbyDataFactory::makeDisconnect(const byte id) {
-    makeEvent(Event::MemberDisconnected);
-    data_.add(id);
+    LobbySchema::Disconnect::encode(*data_, id);
 }
 
 void LobbyDataFactory::makePrepare(const byte id) {
-    makeEvent(Event::SessionPreparation);
-    data_.add(id);
+    LobbySchema::Prepare::encode(*data_, id);
 }
 
 void LobbyDataFactory::makeCrash(const byte id) {
-    makeEvent(Event::MemberCrashed);
-    data_.add(id);
+    LobbySchema::Crash::encode(*data_, id);
 }
 
 void LobbyDataFactory::makeResult(const SessionResult result) {
-    makeEvent(Event::RunResult);
-    data_.add(result);
+    LobbySchema::Result::encode(*data_, result);
 }
 
 void LobbyDataFactory::makeYesNo(const YesNoQuestion request) {
-    makeEvent(Event::AskYesNo);
-    data_.add(request);
+    LobbySchema::YesNo::encode(*data_, request);
 }
 
 void LobbyDataFactory::makeRegistered(const MembersStates& members) {
     makeRegistration(RegistrationResult::Ok);
 
-    data_.add(members.size());
+    data_->add(members.size());
     for (const auto& [id, member] : members) {
-        data_.add(id);
-        data_.put(member.name);
-        data_.add(member.ready);
+        data_->add(id);
+        data_->put(member.name);
+        data_->add(member.ready);
     }
 }
 
 void LobbyDataFactory::makeInvalidIDs(const SessionResult result, const std::vector<byte>& expected) {
     assert(isInvalidIDs(result));
 
-    makeResult(result);
-
-    data_.add(expected.size());
-    for (const byte id : expected)
-        data_.add(id);
+    LobbySchema::InvalidIDs::encode(*data_, result, expected);
 }
 
 void LobbyDataFactory::makeMasterSwitch(const Master& new_master) {
-    makeEvent(Event::MasterSwitch);
+    if (new_master)
+        LobbySchema::NewMaster::encode(*data_, *new_master);
+    else
+        LobbySchema::NotAnyMaster::encode(*data_);
+}
 
-    if (new_master) {
-        data_.add(MasterSwitch::NewMaster);
-        data_.add(*new_master);
-    } else {
-        data_.add(MasterSwitch::NotAnyMaster);
-    }
+void LobbyDataFactory::makeProtocol(const Protocol protocol) {
+    LobbySchema::ProtocolSelected::encode(*data_, protocol);
+}
+
+void LobbyDataFactory::makeCompression(const Compression compression) {
+    LobbySchema::CompressionSelected::encode(*data_, compression);
 }
 
 } // namespace Rbo::Server
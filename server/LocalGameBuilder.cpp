@@ -1,5 +1,6 @@
 #include <Rbo/Server/LocalGameBuilder.hpp>
 
+#include <cmath>
 #include <fstream>
 #include <spdlog/logger.h>
 #include <spdlog/fmt/ostr.h>
@@ -7,42 +8,78 @@
 
 namespace Rbo::Server {
 
-namespace { RandomEngine chkpt_id_rd { now() }; }
+namespace {
 
-std::size_t LocalGameBuilder::counter_ { 0 };
+// Les Sessions de tous les lobbies tirent leurs suffixes ensemble, puis vérifient et réservent le nom obtenu sous ce même verrou
+std::mutex chkpt_id_mtx;
+RandomEngine chkpt_id_rd { now() };
 
-LocalGameBuilder::LocalGameBuilder(fs::path game_file, fs::path checkpts_file, const fs::path& scenes_file, const fs::path& instructions_dir)
+bool isScript(const fs::directory_entry& entry) {
+    return fs::is_regular_file(entry) && entry.path().extension() == ".lua";
+}
+
+}
+
+std::atomic<std::size_t> LocalGameBuilder::counter_ { 0 };
+std::mutex LocalGameBuilder::loaded_games_mtx_;
+std::unordered_map<std::string, LocalGameBuilder::LoadedGame> LocalGameBuilder::loaded_games_;
+std::mutex LocalGameBuilder::checkpoints_mtx_;
+std::unordered_map<std::string, std::shared_ptr<CheckpointWriter>> LocalGameBuilder::checkpoints_;
+
+LocalGameBuilder::LocalGameBuilder(fs::path game_file, fs::path checkpts_file, const fs::path& scenes_file, const fs::path& instructions_dir, fs::path bundle_file)
     : game_ { std::move(game_file) },
       chkpts_ { std::move(checkpts_file) },
+      scenes_ { scenes_file },
+      instructions_ { instructions_dir },
+      bundle_ { std::move(bundle_file) },
       logger_ { rboLogger("GBuilder-" + std::to_string(counter_++)) },
+      chkpts_writer_ { openCheckpoints() },
       exec_ctx_ {},
       provider_ { exec_ctx_, logger_ }
 {
-    logger_.info("Loading scenes...");
+    if (!fs::is_directory(instructions_dir))
+        throw std::invalid_argument { "Given script directory isn't a directory" };
+
+    // Relevée avant la lecture, une modification pendant celle-ci sera donc vue par outdated()
+    scripts_version_ = scriptsVersion();
+    const std::optional<GameBundle> bundle { upToDateBundle() };
+
+    logger_.info("Loading scenes{}...", bundle ? " from bundle" : "");
     try {
-        scenes_table_ = exec_ctx_.script_file(scenes_file.string()).get<sol::table>();
+        if (bundle)
+            scenes_table_ = exec_ctx_.script(bundle->scenes().content, '@' + std::string { bundle->scenes().name }).get<sol::table>();
+        else
+            scenes_table_ = exec_ctx_.script_file(scenes_file.string()).get<sol::table>();
     } catch (const sol::error& err) {
         throw GameLoadingError { err.what() };
     }
     logger_.info("Scenes loaded.");
 
-    logger_.info("Reading instructions...");
-    if (!fs::is_directory(instructions_dir))
-        throw std::invalid_argument { "Given script directory isn't a directory" };
-
-    const fs::directory_iterator scripts {instructions_dir, fs::directory_options::skip_permission_denied };
-
-    for (const fs::directory_entry& entry : scripts) {
-        if (!fs::is_regular_file(entry) || entry.path().extension() != ".lua") {
-            logger_.debug("{} ignored.", entry.path());
-            continue;
+    logger_.info("Reading instructions{}...", bundle ? " from bundle" : "");
+    if (bundle) {
+        for (const GameBundle::Section& script : bundle->instructions()) {
+            logger_.debug("Executing precompiled {}...", script.name);
+            try {
+                exec_ctx_.script(script.content, '@' + std::string { script.name });
+            } catch (const sol::error& err) {
+                throw ScriptLoadingError { instructions_dir / script.name, err.what() };
+            }
         }
-
-        logger_.debug("Executing {}...", entry.path());
-        try {
-            exec_ctx_.script_file(entry.path().string());
-        } catch (const sol::error& err) {
-            throw ScriptLoadingError { entry, err.what() };
+    } else {
+        const fs::directory_iterator scripts { instructions_dir, fs::directory_options::skip_permission_denied };
+
+        for (const fs::directory_entry& entry : scripts) {
+            if (!isScript(entry)) {
+                logger_.debug("{} ignored.", entry.path());
+                continue;
+            }
+
+            logger_.debug("Executing {}...", entry.path());
+            try {
+                exec_ctx_.script_file(entry.path().string());
+            } catch (const sol::error& err) {
+                throw ScriptLoadingError { entry, err.what() };
+            }
         }
     }
     logger_.info("Instructions read.");
@@ -50,20 +87,199 @@ LocalGameBuilder::LocalGameBuilder(fs::path game_file, fs::path checkpts_file, c
     logger_.info("Loading read instructions...");
     provider_.load();
     logger_.info("Instructions loaded.");
+
+    logger_.info("Compiling scenes...");
+    compileScenes();
+    logger_.info("{} scenes compiled.", compiled_scenes_.size());
 }
 
-Game LocalGameBuilder::operator()() const {
-    logger_.info("Loading game {}...", game_);
+void LocalGameBuilder::compileScenes() {
+    for (const auto& [key, scene_obj] : scenes_table_) {
+        // Lua 5.1 ne connaît que des nombres flottants, l'ID doit donc être vérifié
+        const double id { key.get_type() == sol::type::number ? key.as<double>() : -1.0 };
+        if (id < 0 || id > std::numeric_limits<word>::max() || id != std::floor(id))
+            throw GameLoadingError { "Scenes must be indexed by an ID between 0 and " + std::to_string(std::numeric_limits<word>::max()) };
 
-    Game game;
+        try {
+            const word scene_id { static_cast<word>(id) };
+            compiled_scenes_.insert({ scene_id, std::make_shared<const Scene>(compileScene(scene_id, scene_obj)) });
+        } catch (const SceneLoadingError& err) {
+            throw GameLoadingError { err.what() };
+        }
+    }
+}
+
+std::shared_ptr<CheckpointWriter> LocalGameBuilder::openCheckpoints() const {
+    const std::lock_guard checkpoints_lock { checkpoints_mtx_ };
+    std::shared_ptr<CheckpointWriter>& writer { checkpoints_[fs::absolute(chkpts_).string()] };
+
+    if (writer)
+        return writer;
+
+    const bool created { !fs::exists(chkpts_) };
+
+    logger_.info("Indexing checkpoints in {}...", chkpts_);
+    const auto store { std::make_shared<CheckpointStore>(chkpts_) };
+    logger_.info("{} checkpoints indexed.", store->count());
+
+    // Les checkpoints enregistrés avant le journal y sont importés une seule fois, à sa création
+    const fs::path legacy_chkpts { fs::path { chkpts_ }.replace_extension(".json") };
+    if (created && fs::is_regular_file(legacy_chkpts)) {
+        logger_.info("Importing checkpoints from {}...", legacy_chkpts);
+
+        try {
+            std::ifstream in { legacy_chkpts };
+            const json data = json::parse(in);
+
+            for (const auto& [name, chkpt] : data.items())
+                store->save(name, chkpt.get<GameState>());
+        } catch (const json::exception& err) {
+            logger_.error("Unable to import {} : {}", legacy_chkpts, err.what());
+        }
+
+        logger_.info("{} checkpoints imported.", store->count());
+    }
+
+    writer = std::make_shared<CheckpointWriter>(store);
+    return writer;
+}
+
+LocalGameBuilder::ScriptsVersion LocalGameBuilder::scriptsVersion() const {
+    ScriptsVersion version;
+
+    // Une version vide est toujours périmée, la reconstruction signalera alors l'erreur rencontrée
+    std::error_code fs_err;
+    version[scenes_] = fs::last_write_time(scenes_, fs_err);
+    if (fs_err)
+        return {};
+
+    // Un bundle absent n'est pas une erreur, les sources sont alors lues directement
+    const fs::file_time_type bundle_write { fs::last_write_time(bundle_, fs_err) };
+    if (!fs_err)
+        version[bundle_] = bundle_write;
+
+    fs::directory_iterator script { instructions_, fs::directory_options::skip_permission_denied, fs_err };
+    for (; !fs_err && script != fs::directory_iterator {}; script.increment(fs_err)) {
+        if (!isScript(*script))
+            continue;
+
+        version[script->path()] = fs::last_write_time(script->path(), fs_err);
+        if (fs_err)
+            return {};
+    }
+
+    return fs_err ? ScriptsVersion {} : version;
+}
+
+std::optional<GameBundle> LocalGameBuilder::openBundle() const {
     try {
-        std::ifstream in { game_ };
-        json data;
-        in >> data;
+        return std::make_optional<GameBundle>(bundle_);
+    } catch (const BundleError& err) {
+        logger_.warn("{}, reading sources.", err.what());
+        return {};
+    }
+}
+
+// Les scripts du bundle ne sont utilisés que s'il a été généré après leur dernière modification, et à partir de ceux-ci
+std::optional<GameBundle> LocalGameBuilder::upToDateBundle() const {
+    const auto bundle_version { scripts_version_.find(bundle_) };
+    if (bundle_version == scripts_version_.cend()) {
+        logger_.debug("No scripts bundle {}, reading sources.", bundle_);
+        return {};
+    }
+
+    std::vector<std::string> instructions;
+    for (const auto& [script, last_write] : scripts_version_) {
+        if (last_write > bundle_version->second) {
+            logger_.warn("Scripts bundle {} is older than {}, reading sources.", bundle_, script);
+            return {};
+        }
+
+        if (script != scenes_ && script != bundle_)
+            instructions.push_back(script.filename().string());
+    }
+
+    std::optional<GameBundle> bundle { openBundle() };
+    if (!bundle)
+        return {};
+
+    const bool same_scripts {
+        bundle->scenes().name == scenes_.filename().string()
+        && std::equal(instructions.cbegin(), instructions.cend(), bundle->instructions().cbegin(), bundle->instructions().cend(),
+                      [](const std::string& name, const GameBundle::Section& script) { return name == script.name; })
+    };
+
+    if (!same_scripts) {
+        logger_.warn("Scripts bundle {} wasn't built from current scripts, reading sources.", bundle_);
+        return {};
+    }
+
+    return bundle;
+}
+
+bool LocalGameBuilder::outdated() const {
+    return scripts_version_.empty() || scriptsVersion() != scripts_version_;
+}
+
+GamePtr LocalGameBuilder::operator()() const {
+    // Un seul chargement à la fois, les Sessions démarrant en même temps attendent le jeu déjà en cours de lecture
+    const std::lock_guard loaded_games_lock { loaded_games_mtx_ };
+    LoadedGame& loaded { loaded_games_[fs::absolute(game_).string()] };
+
+    std::error_code time_err;
+    const fs::file_time_type game_write { fs::last_write_time(game_, time_err) };
+    if (time_err)
+        throw GameLoadingError { time_err.message() };
+
+    // Le bundle n'est lu que s'il a été généré après la dernière modification du fichier de jeu
+    const fs::file_time_type bundle_write { fs::last_write_time(bundle_, time_err) };
+    const bool bundle_newer { !time_err && bundle_write >= game_write };
+    const fs::file_time_type last_write { bundle_newer ? bundle_write : game_write };
+
+    if (loaded.game && last_write == loaded.last_write) {
+        logger_.debug("Game {} unchanged since last loading.", game_);
+        return loaded.game;
+    }
+
+    std::optional<GameBundle> bundle;
+    if (bundle_newer)
+        bundle = openBundle();
+
+    if (bundle && bundle->game().name != game_.filename().string()) {
+        logger_.warn("Game bundle {} wasn't built from {}, reading sources.", bundle_, game_);
+        bundle.reset();
+    }
 
-        if (in.fail())
+    // Projeté en mémoire, le contenu du bundle est lu sans copie
+    std::string file_content;
+    std::string_view content;
+    if (bundle) {
+        content = bundle->game().content;
+    } else {
+        std::ifstream in { game_, std::ios::binary };
+        file_content.assign(std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> {});
+
+        if (in.bad())
             throw GameLoadingError { "Error on input stream" };
 
+        content = file_content;
+    }
+
+    // Un fichier réécrit à l'identique n'est pas chargé à nouveau
+    const std::size_t hash { std::hash<std::string_view> {}(content) };
+    if (loaded.game && hash == loaded.hash) {
+        logger_.debug("Game {} rewritten without any change.", game_);
+        loaded.last_write = last_write;
+
+        return loaded.game;
+    }
+
+    logger_.info("Loading game {}{}...", game_, bundle ? " from bundle" : "");
+
+    Game game;
+    try {
+        const json data = bundle ? json::from_msgpack(content.cbegin(), content.cend()) : json::parse(content);
+
         FromJsonWrapper<Messages> messages { game.messages };
 
         data.at("name").get_to(game.name);
@@ -87,81 +303,47 @@ Game LocalGameBuilder::operator()() const {
         throw GameLoadingError { err.what() };
     }
 
+    loaded = { last_write, hash, std::make_shared<const Game>(std::move(game)) };
+
     logger_.info("Game loaded.");
-    return game;
+    return loaded.game;
 }
 
 GameState LocalGameBuilder::load(const std::string& name) const {
-    logger_.info("Opening checkpoints in {} to find \"{}\"...", chkpts_, name);
-
-    GameState state;
-    try {
-        std::ifstream in { chkpts_ };
-        json data;
-        in >> data;
-
-        if (in.fail())
-            throw std::runtime_error { "Error on input stream" };
-
-        const json& chkpt { data.at(name) };
-        chkpt.at("scene").get_to(state.scene);
-        chkpt.at("global").get_to(state.global);
-        chkpt.at("leader").get_to(state.leader);
-        chkpt.at("players").get_to(state.players);
-    } catch (const json::exception& err) {
-        throw std::runtime_error { err.what() };
-    }
-
+    logger_.info("Reading checkpoint \"{}\" from {}...", name, chkpts_);
+    GameState state { chkpts_writer_->load(name) };
     logger_.info("Searched checkpoint read.");
+
     return state;
 }
 
-std::string LocalGameBuilder::save(const std::string& name, const GameState& state) const {
+SavedCheckpoint LocalGameBuilder::save(const std::string& name, const GameState& state) const {
+    const std::lock_guard id_lock { chkpt_id_mtx };
     const std::string final_name { name + '_' + std::to_string(std::uniform_int_distribution { 0, 5000 } (chkpt_id_rd)) };
 
-    logger_.info("Opening checkpoints in {} to write \"{}\" under the name of \"{}\"...", chkpts_, name, final_name);
-    json data;
-    try {
-        std::ifstream in { chkpts_ };
-        in >> data;
-
-        if (in.fail())
-            throw GameLoadingError { "Error on input stream" };
-    } catch (const json::exception& err) {
-        throw GameLoadingError { err.what() };
-    }
-
-    json& chkpt { data[final_name] };
-    if (chkpt.is_object())
+    logger_.info("Queuing checkpoint \"{}\" for {} under the name of \"{}\"...", name, chkpts_, final_name);
+    if (chkpts_writer_->contains(final_name))
         throw CheckpointAlreadyExists { final_name };
 
-    try {
-        std::ofstream out { chkpts_ };
-
-        chkpt = json::object();
-        chkpt["scene"] = state.scene;
-        chkpt["global"] = state.global;
-        chkpt["leader"] = state.leader;
-        chkpt["players"] = state.players;
+    // Mis en file avant le relâchement du verrou, le nom est alors visible des autres Sessions
+    return { final_name, chkpts_writer_->save(final_name, state) };
+}
 
-        out << data.dump(4);
-        if (out.fail())
-            throw GameSavingError { "Error in input stream" };
-    } catch (const json::exception& err) {
-        throw GameSavingError { err.what() };
-    }
+ScenePtr LocalGameBuilder::buildScene(const word id) const {
+    const auto compiled { compiled_scenes_.find(id) };
+    if (compiled == compiled_scenes_.cend())
+        throw SceneLoadingError { id, "Unknown scene ID" };
 
-    logger_.info("Checkpoint saved.");
-    return final_name;
+    return compiled->second;
 }
 
-Scene LocalGameBuilder::buildScene(const word id) const {
-    logger_.info("Building scene {}...", id);
+Scene LocalGameBuilder::compileScene(const word id, const sol::object& scene_obj) const {
+    logger_.debug("Compiling scene {}...", id);
 
-    Scene scene;
-    const sol::object scene_obj { scenes_table_[id].get<sol::object>() };
     if (scene_obj.get_type() != sol::type::table)
-        throw SceneLoadingError { id, "Unknown scene ID" };
+        throw SceneLoadingError { id, "A scene must be a Lua table" };
+
+    Scene scene;
 
     for (const auto& instruction_entry : scene_obj.as<sol::table>()) {
         if (instruction_entry.second.get_type() != sol::type::table)
@@ -174,10 +356,13 @@ Scene LocalGameBuilder::buildScene(const word id) const {
         if (name.get_type() != sol::type::string || args.get_type() != sol::type::table)
             throw SceneLoadingError { id, "Invalid instruction : [1] != string or [2] != table" };
 
-        scene.push_back(provider_.get(name.as<std::string>(), args.as<sol::table>()));
+        const std::string instruction_name { name.as<std::string>() };
+        if (!provider_.has(instruction_name))
+            throw SceneLoadingError { id, "Unknown instruction \"" + instruction_name + '"' };
+
+        scene.push_back(provider_.get(instruction_name, args.as<sol::table>()));
     }
 
-    logger_.info("Scene built.");
     return scene;
 }
 
@@ -32,9 +32,9 @@ BOOL WINAPI StopHandler(DWORD event) {
 #endif
 
 int main(const int argc, const char* argv[]) {
-    constexpr std::string_view usage { "Usage : <ip> <port> <prepare_delay (ms)>" };
+    constexpr std::string_view usage { "Usage : <ip> <port> <prepare_delay (ms)> [lobbies_count] [threads|coroutines]" };
 
-    if (argc != 4) {
+    if (argc < 4 || argc > 6) {
         std::cerr << usage << std::endl;
         return 1;
     }
@@ -42,6 +42,8 @@ int main(const int argc, const char* argv[]) {
     const std::string ip { argv[1] };
     ushort port;
     ulong prepare_delay;
+    ushort lobbies_count { 1 };
+    Rbo::Server::SessionsMode sessions_mode { Rbo::Server::SessionsMode::Threads };
 
     try {
         if (ip != "ipv4" && ip != "ipv6")
@@ -49,6 +51,21 @@ int main(const int argc, const char* argv[]) {
 
         port = std::stoi(std::string { argv[2] });
         prepare_delay = std::stoul(std::string { argv[3] });
+
+        if (argc >= 5)
+            lobbies_count = std::stoi(std::string { argv[4] });
+
+        if (argc == 6) {
+            const std::string mode { argv[5] };
+
+            if (mode == "coroutines")
+                sessions_mode = Rbo::Server::SessionsMode::Coroutines;
+            else if (mode != "threads")
+                throw std::logic_error { "Unknown sessions mode" };
+        }
+
+        if (lobbies_count == 0 || port + lobbies_count - 1 > std::numeric_limits<ushort>::max())
+            throw std::logic_error { "Invalid lobbies count" };
     } catch (const std::logic_error&) {
         std::cerr << usage << std::endl;
         return 1;
@@ -61,13 +78,18 @@ int main(const int argc, const char* argv[]) {
         logger.info("Starting server...");
 
         Rbo::io::io_context server;
-        Rbo::Server::Lobby lobby {
-                server,
-                Rbo::tcp::endpoint{ ip == "ipv4" ? Rbo::tcp::v4() : Rbo::tcp::v6(), port },
-                prepare_delay
-        };
 
-        Rbo::Server::Executor executor { server, lobby, logger };
+        // Un lobby par port, à partir du port donné
+        std::list<Rbo::Server::Lobby> lobbies;
+        for (ushort i { 0 }; i < lobbies_count; i++) {
+            lobbies.emplace_back(
+                    server,
+                    Rbo::tcp::endpoint{ ip == "ipv4" ? Rbo::tcp::v4() : Rbo::tcp::v6(), static_cast<ushort>(port + i) },
+                    prepare_delay
+            );
+        }
+
+        Rbo::Server::Executor executor { server, lobbies, logger, std::thread::hardware_concurrency(), sessions_mode };
 
         const auto stop_handler = [&executor, &logger](const Rbo::ErrCode err, const int sig) {
             std::cout << "\b\b";
@@ -90,7 +112,7 @@ int main(const int argc, const char* argv[]) {
 #endif
 
         done_successfully = executor.start<Rbo::Server::LocalGameBuilder>(
-                "game/game.json", "game/chkpts.json", "game/scenes.lua", "instructions"
+                "game/game.json", "game/chkpts.rbo", "game/scenes.lua", "instructions", "game/game.rbo"
         );
     } catch (const std::exception& err) {
         logger.critical(err.what());
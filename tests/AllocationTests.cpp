@@ -0,0 +1,106 @@
+#define BOOST_TEST_MODULE Allocation
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <boost/test/unit_test.hpp>
+#include <Rbo/SessionDataFactory.hpp>
+
+using namespace Rbo;
+
+namespace {
+
+std::atomic<std::size_t> allocations { 0 };
+
+// Nombre d'allocations faites par l'appel donné
+template<typename Call>
+std::size_t countAllocations(Call&& call) {
+    const std::size_t before { allocations };
+    call();
+
+    return allocations - before;
+}
+
+}
+
+void* operator new(const std::size_t size) {
+    allocations++;
+
+    if (void* const memory { std::malloc(size == 0 ? 1 : size) })
+        return memory;
+
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* const memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* const memory, const std::size_t) noexcept {
+    std::free(memory);
+}
+
+BOOST_AUTO_TEST_SUITE(BigEndian)
+
+BOOST_AUTO_TEST_CASE(CompileTime) {
+    constexpr auto written { []() {
+        std::array<byte, sizeof(int)> output {};
+        writeBigEndian(-30304, output.data());
+
+        return output;
+    }() };
+
+    static_assert(written[0] == 0xFF && written[1] == 0xFF && written[2] == 0x89 && written[3] == 0xA0);
+    static_assert(readBigEndian<int>(written.data()) == -30304);
+    static_assert(readBigEndian<short>(written.data() + 2) == -30304);
+
+    constexpr std::array<byte, sizeof(ulong)> max_bytes { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    static_assert(readBigEndian<ulong>(max_bytes.data()) == std::numeric_limits<ulong>::max());
+
+    BOOST_CHECK_EQUAL(readBigEndian<int>(written.data()), -30304);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(NoAllocation)
+
+BOOST_AUTO_TEST_CASE(Numerics) {
+    Data data;
+
+    const std::size_t count { countAllocations([&data]() {
+        data.putNumeric<byte>(1);
+        data.putNumeric<short>(-2);
+        data.putNumeric<int>(3);
+        data.putNumeric<ulong>(4);
+        data.putVarint(5);
+        data.putSignedVarint(-6);
+        data.add(true);
+        data.refreshLength();
+    }) };
+
+    BOOST_CHECK_EQUAL(count, 0);
+    BOOST_CHECK_EQUAL(readBigEndian<word>(data.buffer()), data.count());
+}
+
+// Seul le bloc partagé par la fabrique et ses paquets est alloué
+BOOST_AUTO_TEST_CASE(Factories) {
+    BOOST_CHECK_EQUAL(countAllocations([]() {
+        SessionDataFactory factory;
+        factory.makeGlobalStat("test", Stat { 0, { 468, 2020 }, false, true });
+        factory.dataWithLength();
+    }), 1);
+
+    BOOST_CHECK_EQUAL(countAllocations([]() {
+        SessionDataFactory factory;
+        factory.makeDiceRoll(ACTIVE_PLAYERS, "A message", 3, -1, {});
+        factory.dataWithLength();
+    }), 1);
+
+    BOOST_CHECK_EQUAL(countAllocations([]() {
+        SessionDataFactory factory;
+        factory.makeSwitch(42);
+        factory.dataWithLength();
+    }), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+#define BOOST_TEST_MODULE CheckpointStore
+
+#include <boost/test/unit_test.hpp>
+#include <Rbo/CheckpointStore.hpp>
+
+using namespace Rbo;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+GameState makeState(const word scene) {
+    const PlayerState player { Death { "Fell" }, { { "hp", Stat { 3, { 0, 10 }, false, true } } }, { { "bag", { { "Key", 1 } } } }, { { "bag", 5 } } };
+    return { scene, { { "gold", Stat { 42, { 0, 100 }, false, false } } }, 2, { { 2, player } } };
+}
+
+// Journal vide, supprimé à la fin du test
+struct TemporaryStore {
+    const fs::path path { fs::temp_directory_path() / "rbo-checkpoint-store-tests.rbo" };
+
+    TemporaryStore() { fs::remove(path); }
+    ~TemporaryStore() { fs::remove(path); }
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(Journal, TemporaryStore)
+
+BOOST_AUTO_TEST_CASE(SaveLoad) {
+    CheckpointStore store { path };
+    store.save("First", makeState(1));
+    store.save("Second", makeState(2));
+
+    const GameState loaded { store.load("Second") };
+    BOOST_CHECK_EQUAL(loaded.scene, 2);
+    BOOST_CHECK_EQUAL(loaded.leader, 2);
+    BOOST_CHECK(loaded.global == makeState(2).global);
+    BOOST_CHECK_EQUAL(*loaded.players.at(2).death, "Fell");
+    BOOST_CHECK_EQUAL(loaded.players.at(2).inventories.at("bag").at("Key"), 1);
+
+    BOOST_CHECK_THROW(store.load("Third"), UnknownCheckpoint);
+}
+
+BOOST_AUTO_TEST_CASE(IndexedAtOpening) {
+    {
+        CheckpointStore store { path };
+        store.save("First", makeState(1));
+        store.save("First", makeState(3));
+    }
+
+    const CheckpointStore store { path };
+    BOOST_CHECK_EQUAL(store.count(), 1);
+    BOOST_CHECK_EQUAL(store.load("First").scene, 3);
+    BOOST_CHECK_GT(store.deadBytes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(InterruptedWriteTruncated) {
+    {
+        CheckpointStore store { path };
+        store.save("First", makeState(1));
+        store.save("Second", makeState(2));
+    }
+
+    const auto intact_size { fs::file_size(path) };
+    fs::resize_file(path, intact_size - 5);
+    {
+        const CheckpointStore store { path };
+        BOOST_CHECK(store.contains("First"));
+        BOOST_CHECK(!store.contains("Second"));
+    }
+
+    CheckpointStore store { path };
+    store.save("Third", makeState(3));
+    BOOST_CHECK_EQUAL(store.load("First").scene, 1);
+    BOOST_CHECK_EQUAL(store.load("Third").scene, 3);
+}
+
+BOOST_AUTO_TEST_CASE(Compact) {
+    CheckpointStore store { path };
+    store.save("First", makeState(1));
+    store.save("Second", makeState(2));
+    store.save("First", makeState(3));
+
+    const auto size { fs::file_size(path) };
+    store.compact();
+
+    BOOST_CHECK_EQUAL(store.deadBytes(), 0);
+    BOOST_CHECK_LT(fs::file_size(path), size);
+    BOOST_CHECK_EQUAL(store.load("First").scene, 3);
+    BOOST_CHECK_EQUAL(store.load("Second").scene, 2);
+
+    store.save("Fourth", makeState(4));
+    BOOST_CHECK_EQUAL(CheckpointStore { path }.count(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(FailedCompactionDeferred) {
+    GameState big_state { makeState(1) };
+    big_state.global.insert({ std::string(200000, 'x'), Stat { 0, { 0, 1 }, false, false } });
+
+    // Le journal compacté ne peut pas être créé tant qu'un dossier occupe son chemin
+    const fs::path compacted { path.string() + ".tmp" };
+    fs::create_directories(compacted / "busy");
+
+    CheckpointStore store { path };
+    for (int i { 0 }; i < 10; i++)
+        BOOST_CHECK_NO_THROW(store.save("First", big_state));
+
+    BOOST_CHECK_GT(store.deadBytes(), CheckpointStore::COMPACTION_THRESHOLD);
+    BOOST_CHECK_EQUAL(store.load("First").scene, 1);
+
+    fs::remove_all(compacted);
+    for (int i { 0 }; i < 20 && store.deadBytes() != 0; i++)
+        store.save("First", big_state);
+
+    BOOST_CHECK_EQUAL(store.deadBytes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Encodings) {
+    std::vector<std::uintmax_t> sizes;
+    for (const CheckpointEncoding encoding : { CheckpointEncoding::Json, CheckpointEncoding::Cbor, CheckpointEncoding::MessagePack }) {
+        fs::remove(path);
+        {
+            CheckpointStore store { path, encoding };
+            store.save("First", makeState(1));
+        }
+
+        // L'encodage choisi à la création reste celui du journal
+        const CheckpointStore store { path };
+        BOOST_CHECK(store.encoding() == encoding);
+        BOOST_CHECK(store.load("First").global == makeState(1).global);
+
+        sizes.push_back(fs::file_size(path));
+    }
+
+    BOOST_CHECK_LT(sizes[1], sizes[0]);
+    BOOST_CHECK_LT(sizes[2], sizes[0]);
+}
+
+BOOST_AUTO_TEST_CASE(FirstFormatVersion) {
+    {
+        CheckpointStore store { path };
+        store.save("First", makeState(1));
+    }
+
+    // Même journal sans l'octet d'encodage, ajouté par la version 2
+    std::ifstream in { path, std::ios::binary };
+    std::string content { std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> {} };
+    in.close();
+
+    content.erase(CheckpointStore::MAGIC.size(), 2);
+    content.insert(CheckpointStore::MAGIC.size(), 1, '\x01');
+    std::ofstream { path, std::ios::binary | std::ios::trunc } << content;
+
+    CheckpointStore store { path };
+    BOOST_CHECK_EQUAL(store.load("First").scene, 1);
+
+    store.save("Second", makeState(2));
+    store.compact();
+    BOOST_CHECK_EQUAL(CheckpointStore { path }.load("Second").scene, 2);
+}
+
+BOOST_AUTO_TEST_CASE(NotAStore) {
+    std::ofstream { path } << "{}";
+    BOOST_CHECK_THROW(CheckpointStore { path }, CheckpointStoreError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
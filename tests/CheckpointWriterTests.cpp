@@ -0,0 +1,81 @@
+#define BOOST_TEST_MODULE CheckpointWriter
+
+#include <boost/test/unit_test.hpp>
+#include <Rbo/CheckpointWriter.hpp>
+
+using namespace Rbo;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+GameState makeState(const word scene) {
+    return { scene, { { "gold", Stat { 42, { 0, 100 }, false, false } } }, 1, {} };
+}
+
+// Écrivain sur un journal vide, supprimé à la fin du test
+struct TemporaryWriter {
+    const fs::path path { fs::temp_directory_path() / "rbo-checkpoint-writer-tests.rbo" };
+    std::shared_ptr<CheckpointStore> store;
+    std::optional<CheckpointWriter> writer;
+
+    TemporaryWriter() {
+        fs::remove(path);
+
+        store = std::make_shared<CheckpointStore>(path);
+        writer.emplace(store);
+    }
+
+    ~TemporaryWriter() {
+        writer.reset();
+        store.reset();
+
+        fs::remove(path);
+    }
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(WriteBehind, TemporaryWriter)
+
+BOOST_AUTO_TEST_CASE(Written) {
+    std::shared_future<void> written { writer->save("First", makeState(1)) };
+    BOOST_CHECK(writer->contains("First"));
+    BOOST_CHECK_EQUAL(writer->load("First").scene, 1);
+
+    written.get();
+    BOOST_CHECK(store->contains("First"));
+    BOOST_CHECK_EQUAL(CheckpointStore { path }.load("First").scene, 1);
+}
+
+BOOST_AUTO_TEST_CASE(LatestStateKept) {
+    for (word scene { 1 }; scene <= 50; scene++)
+        writer->save("First", makeState(scene));
+
+    BOOST_CHECK_EQUAL(writer->load("First").scene, 50);
+
+    writer->flush();
+    BOOST_CHECK_EQUAL(store->load("First").scene, 50);
+}
+
+BOOST_AUTO_TEST_CASE(PendingWrittenOnDestruction) {
+    writer->save("First", makeState(1));
+    writer->save("Second", makeState(2));
+    writer.reset();
+
+    BOOST_CHECK_EQUAL(CheckpointStore { path }.count(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(FailureReported) {
+    GameState invalid { makeState(1) };
+    invalid.global.insert({ "\xFF", Stat {} }); // Pas de l'UTF-8, non sérialisable en JSON
+
+    std::shared_future<void> written { writer->save("Invalid", invalid) };
+    BOOST_CHECK_THROW(written.get(), std::exception);
+
+    writer->save("Valid", makeState(2)).get();
+    BOOST_CHECK(!writer->contains("Invalid"));
+    BOOST_CHECK(writer->contains("Valid"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
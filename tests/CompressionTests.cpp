@@ -0,0 +1,126 @@
+#define BOOST_TEST_MODULE Compression
+
+#include <boost/test/unit_test.hpp>
+#include <zlib.h>
+#include <Rbo/Compression.hpp>
+#include <Rbo/SessionDataFactory.hpp>
+
+using namespace Rbo;
+
+BOOST_TEST_DONT_PRINT_LOG_VALUE(std::vector<byte>)
+
+// Décompression telle que faite par un client, avec un flux unique pour tous les messages reçus
+struct Decompressor {
+    z_stream stream;
+
+    Decompressor() : stream {} {
+        BOOST_REQUIRE_EQUAL(inflateInit2(&stream, -MAX_WBITS), Z_OK);
+    }
+
+    ~Decompressor() {
+        inflateEnd(&stream);
+    }
+
+    std::vector<byte> decompress(const Data& compressed) {
+        BOOST_REQUIRE_EQUAL(compressed.buffer()[Data::LENGTH_SIZE], COMPRESSED_EVENT);
+
+        std::vector<byte> input { compressed.buffer() + Data::LENGTH_SIZE + 1, compressed.buffer() + compressed.count() };
+        input.insert(input.end(), { 0x00, 0x00, 0xFF, 0xFF });
+
+        std::vector<byte> output(MAX_CONTENT_LENGTH);
+        stream.next_in = input.data();
+        stream.avail_in = static_cast<uInt>(input.size());
+        stream.next_out = output.data();
+        stream.avail_out = static_cast<uInt>(output.size());
+
+        BOOST_REQUIRE_EQUAL(inflate(&stream, Z_SYNC_FLUSH), Z_OK);
+        BOOST_REQUIRE_EQUAL(stream.avail_in, 0);
+
+        output.resize(output.size() - stream.avail_out);
+        return output;
+    }
+};
+
+std::vector<byte> content(const Data& data) {
+    return { data.buffer() + Data::LENGTH_SIZE, data.buffer() + data.count() };
+}
+
+BOOST_FIXTURE_TEST_SUITE(Deflate, Decompressor)
+
+BOOST_AUTO_TEST_CASE(TooShort) {
+    SessionDataFactory factory;
+    factory.makeSwitch(1);
+
+    BOOST_CHECK(!Compressor {}.worthCompressing(factory.data()));
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip) {
+    const std::string text { "Vous entrez dans la taverne. Le tavernier vous salue, puis retourne à ses verres." };
+
+    SessionDataFactory factory;
+    factory.makeNormalText(text);
+
+    Compressor compressor;
+    BOOST_REQUIRE(compressor.worthCompressing(factory.data()));
+
+    const Packet compressed { compressor.compress(factory.data()) };
+
+    BOOST_CHECK_EQUAL(readBigEndian<word>(compressed.data().buffer()), compressed.count());
+    BOOST_CHECK_EQUAL(decompress(compressed.data()), content(factory.data()));
+}
+
+// Les messages suivants profitent de l'historique du flux
+BOOST_AUTO_TEST_CASE(Streaming) {
+    const std::string text { "Le gobelin vous attaque et vous inflige des dégâts, vous perdez des points de vie." };
+
+    Compressor compressor;
+    std::size_t first_length { 0 };
+
+    for (std::size_t i { 0 }; i < 5; i++) {
+        SessionDataFactory factory;
+        factory.makeNormalText(text);
+
+        const Packet compressed { compressor.compress(factory.data()) };
+        if (i == 0)
+            first_length = compressed.count();
+        else
+            BOOST_CHECK_LT(compressed.count() * 3, first_length);
+
+        BOOST_CHECK_EQUAL(decompress(compressed.data()), content(factory.data()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Fragmented) {
+    OptionsList options;
+    for (std::size_t i { 0 }; i < 5; i++) {
+        std::string option;
+        for (std::size_t j { 0 }; option.length() < MAX_LENGTH / 2; j++)
+            option += "Paragraphe " + std::to_string(j) + " de l'option " + std::to_string(i) + ". ";
+
+        options.push_back(option);
+    }
+
+    SessionDataFactory factory;
+    factory.makeOptions(ALL_PLAYERS, "Choix", options);
+
+    Compressor compressor;
+    const Packet compressed { compressor.compress(factory.data()) };
+
+    BOOST_CHECK(factory.dataWithLength().fragmented());
+    BOOST_CHECK_LT(compressed.count(), factory.data().count());
+    BOOST_CHECK_EQUAL(decompress(compressed.data()), content(factory.data()));
+}
+
+BOOST_AUTO_TEST_CASE(Incompressible) {
+    std::vector<byte> random_content(MAX_CONTENT_LENGTH);
+
+    unsigned state { 42 };
+    for (byte& b : random_content) {
+        state = state * 1103515245 + 12345;
+        b = static_cast<byte>(state >> 16);
+    }
+
+    BOOST_CHECK(!Compressor {}.worthCompressing(Data { random_content }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
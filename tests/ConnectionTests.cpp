@@ -0,0 +1,197 @@
+#define BOOST_TEST_MODULE Connection
+
+#include <boost/test/unit_test.hpp>
+#include <future>
+#include <thread>
+#include <Rbo/Connection.hpp>
+#include <Rbo/Data.hpp>
+
+using namespace Rbo;
+
+struct ConnectedPair {
+    io::io_context context;
+    io::executor_work_guard<io::io_context::executor_type> work;
+    tcp::socket client;
+    ConnectionPtr server;
+    std::thread events;
+
+    ConnectedPair() : work { context.get_executor() }, client { context } {
+        tcp::acceptor acceptor { context, tcp::endpoint { io::ip::address_v4::loopback(), 0 } };
+        client.connect(acceptor.local_endpoint());
+
+        server = std::make_shared<Connection>(acceptor.accept());
+        events = std::thread { [this]() { context.run(); } };
+    }
+
+    ~ConnectedPair() {
+        work.reset();
+        context.stop();
+        events.join();
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(Send, ConnectedPair)
+
+BOOST_AUTO_TEST_CASE(InOrder) {
+    const Packet first { std::make_shared<const Data>(std::vector<byte> { 1, 2, 3 }) };
+    const Packet second { std::make_shared<const Data>(std::vector<byte> { 4, 5 }) };
+
+    std::promise<std::size_t> second_written;
+    BOOST_CHECK(!server->send(first));
+    BOOST_CHECK(!server->send(second, [&second_written](const ErrCode err, const std::size_t length) {
+        BOOST_CHECK(!err);
+        second_written.set_value(length);
+    }));
+
+    BOOST_CHECK_EQUAL(second_written.get_future().get(), second.count());
+
+    std::array<byte, 9> received;
+    io::read(client, io::buffer(received));
+
+    const std::array<byte, 9> expected { 0, 0, 1, 2, 3, 0, 0, 4, 5 };
+    BOOST_CHECK(received == expected);
+}
+
+BOOST_AUTO_TEST_CASE(Held) {
+    const Packet packet { std::make_shared<const Data>(std::vector<byte> { 7 }) };
+
+    std::promise<void> last_written;
+    server->hold(true);
+    for (std::size_t i { 0 }; i < 99; i++)
+        BOOST_CHECK(!server->send(packet));
+
+    BOOST_CHECK(!server->send(packet, [&last_written](const ErrCode err, const std::size_t) {
+        BOOST_CHECK(!err);
+        last_written.set_value();
+    }));
+
+    BOOST_CHECK(client.available() == 0);
+
+    server->hold(false);
+    last_written.get_future().get();
+
+    std::array<byte, 300> received;
+    io::read(client, io::buffer(received));
+
+    for (std::size_t i { 0 }; i < received.size(); i += 3)
+        BOOST_CHECK_EQUAL(received[i + 2], 7);
+}
+
+BOOST_AUTO_TEST_CASE(Fragmented) {
+    std::vector<byte> content(MAX_LENGTH + 1000);
+    for (std::size_t i { 0 }; i < content.size(); i++)
+        content[i] = static_cast<byte>(i % 251);
+
+    const Packet packet { std::make_shared<const Data>(content) };
+    BOOST_CHECK(!server->send(packet));
+
+    // Les fragments sont lus comme des paquets ordinaires, leur contenu mis bout à bout
+    std::vector<byte> reassembled;
+    for (std::size_t i { 0 }; i < packet.fragments(); i++) {
+        std::array<byte, Packet::FRAGMENT_HEADER_SIZE> header;
+        io::read(client, io::buffer(header));
+
+        BOOST_CHECK_EQUAL(header[Data::LENGTH_SIZE], FRAGMENT_EVENT);
+        BOOST_CHECK_EQUAL(readBigEndian<word>(header.data() + 3), i);
+        BOOST_CHECK_EQUAL(readBigEndian<word>(header.data() + 5), packet.fragments());
+
+        std::vector<byte> fragment_content(readBigEndian<word>(header.data()) - Packet::FRAGMENT_HEADER_SIZE);
+        io::read(client, io::buffer(fragment_content));
+        reassembled.insert(reassembled.end(), fragment_content.cbegin(), fragment_content.cend());
+    }
+
+    BOOST_CHECK(reassembled == content);
+}
+
+BOOST_AUTO_TEST_CASE(SlowConsumer) {
+    const Packet packet { std::make_shared<const Data>(std::vector<byte>(MAX_LENGTH - Data::LENGTH_SIZE, 0)) };
+
+    ErrCode send_err;
+    for (std::size_t i { 0 }; i < 1000000 && !send_err; i++)
+        send_err = server->send(packet);
+
+    BOOST_CHECK(send_err == io::error::basic_errors::no_buffer_space);
+    BOOST_CHECK(server->send(packet) == send_err);
+}
+
+BOOST_AUTO_TEST_CASE(FailedWhileHeld) {
+    const Packet packet { std::make_shared<const Data>(std::vector<byte>(MAX_LENGTH - Data::LENGTH_SIZE, 0)) };
+
+    std::promise<ErrCode> first_failed;
+    server->hold(true);
+    BOOST_CHECK(!server->send(packet, [&first_failed](const ErrCode err, const std::size_t) { first_failed.set_value(err); }));
+
+    ErrCode send_err;
+    while (!send_err)
+        send_err = server->send(packet);
+
+    // Aucune écriture n'était en cours, les paquets retenus échouent tout de même
+    BOOST_CHECK(first_failed.get_future().get() == io::error::basic_errors::no_buffer_space);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_SUITE(Receive, ConnectedPair)
+
+BOOST_AUTO_TEST_CASE(Pipelined) {
+    const std::array<byte, 7> sent { 3, 'A', 'b', 0, 1, 'C', 0 };
+    io::write(client, io::buffer(sent));
+
+    std::vector<std::vector<byte>> frames;
+    std::promise<void> done;
+
+    const FrameHandler collect { [&frames](const ErrCode err, const ReceiveBuffer& frame, const std::size_t length) {
+        BOOST_CHECK(!err);
+        frames.emplace_back(frame.cbegin(), frame.cbegin() + length);
+    } };
+
+    server->receive(FrameType::IdentifiedString, [&](const ErrCode err, const ReceiveBuffer& frame, const std::size_t length) {
+        collect(err, frame, length);
+
+        server->receive(FrameType::Byte, [&](const ErrCode err, const ReceiveBuffer& frame, const std::size_t length) {
+            collect(err, frame, length);
+
+            server->receive(FrameType::String, [&](const ErrCode err, const ReceiveBuffer& frame, const std::size_t length) {
+                collect(err, frame, length);
+                done.set_value();
+            });
+        });
+    });
+
+    done.get_future().get();
+
+    const std::vector<std::vector<byte>> expected { { 3, 'A', 'b', 0 }, { 1 }, { 'C', 0 } };
+    BOOST_CHECK(frames == expected);
+}
+
+BOOST_AUTO_TEST_CASE(Split) {
+    std::promise<std::vector<byte>> received;
+    server->receive(FrameType::String, [&received](const ErrCode err, const ReceiveBuffer& frame, const std::size_t length) {
+        BOOST_CHECK(!err);
+        received.set_value({ frame.cbegin(), frame.cbegin() + length });
+    });
+
+    const std::array<byte, 2> first_part { 'H', 'e' };
+    const std::array<byte, 2> last_part { 'y', 0 };
+
+    io::write(client, io::buffer(first_part));
+    std::this_thread::sleep_for(std::chrono::milliseconds { 20 });
+    io::write(client, io::buffer(last_part));
+
+    const std::vector<byte> expected { 'H', 'e', 'y', 0 };
+    BOOST_CHECK(received.get_future().get() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(Oversized) {
+    const std::vector<byte> sent(std::tuple_size_v<ReceiveBuffer> + 1, 'x');
+    io::write(client, io::buffer(sent));
+
+    std::promise<ErrCode> received;
+    server->receive(FrameType::String, [&received](const ErrCode err, const ReceiveBuffer&, const std::size_t) {
+        received.set_value(err);
+    });
+
+    BOOST_CHECK(received.get_future().get() == io::error::basic_errors::message_size);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -8,32 +8,36 @@ using namespace Rbo;
 
 namespace dataset = boost::unit_test::data;
 
-BOOST_TEST_DONT_PRINT_LOG_VALUE(DataBuffer)
+BOOST_TEST_DONT_PRINT_LOG_VALUE(std::vector<byte>)
+
+std::vector<byte> bytes(const Data& data) {
+    return { data.buffer(), data.buffer() + data.count() };
+}
 
 BOOST_AUTO_TEST_SUITE(Ctor)
 
 BOOST_AUTO_TEST_CASE(Default) {
-    const DataBuffer expected_buffer { 0 };
+    const std::vector<byte> expected_bytes { 0, 0 };
 
     const Data data;
 
     BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE);
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
 }
 
 BOOST_AUTO_TEST_CASE(BytesVector) {
-    const DataBuffer expected_buffer { 0, 0, 33, 57, 128, 255, 124, 0 };
+    const std::vector<byte> expected_bytes { 0, 0, 33, 57, 128, 255, 124, 0 };
     const std::vector<byte> arg { 33, 57, 128, 255, 124, 0 };
 
     const Data data { arg };
 
     BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + arg.size());
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
 }
 
 BOOST_AUTO_TEST_CASE(Overflow) {
     std::vector<byte> arg;
-    arg.resize(10000, 0);
+    arg.resize(MAX_CONTENT_LENGTH + 1, 0);
 
     BOOST_CHECK_THROW(Data { arg }, BufferOverflow);
 }
@@ -45,35 +49,35 @@ BOOST_AUTO_TEST_SUITE(Add)
 BOOST_DATA_TEST_CASE(Byte, dataset::xrange(25))
 {
     const byte value { static_cast<byte>(sample) };
-    const DataBuffer expected_buffer { 0, 0, value };
+    const std::vector<byte> expected_bytes { 0, 0, value };
 
     Data data;
     data.add(value);
 
     BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + 1);
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
 }
 
 BOOST_AUTO_TEST_CASE(BoolTrue) {
     const bool value { true };
-    const DataBuffer expected_buffer { 0, 0, 1 };
+    const std::vector<byte> expected_bytes { 0, 0, 1 };
 
     Data data;
     data.add(value);
 
     BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + 1);
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
 }
 
 BOOST_AUTO_TEST_CASE(BoolFalse) {
     const bool value { false };
-    const DataBuffer expected_buffer { 0, 0, 0 };
+    const std::vector<byte> expected_bytes { 0, 0, 0 };
 
     Data data;
     data.add(value);
 
     BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + 1);
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
 }
 
 BOOST_AUTO_TEST_CASE(Overflow) {
@@ -95,18 +99,18 @@ BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE(Put)
 
 BOOST_AUTO_TEST_CASE(EmptyString) {
-    const DataBuffer expected_buffer { 0, 0, 0, 0 };
+    const std::vector<byte> expected_bytes { 0, 0, 0, 0 };
     const std::string arg { "" };
 
     Data data;
     data.put(arg);
 
     BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + arg.size() + 2);
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
 }
 
 BOOST_AUTO_TEST_CASE(String) {
-    const DataBuffer expected_buffer {
+    const std::vector<byte> expected_bytes {
         0, 0, 0, 12, 'H', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd', '!'
     };
     const std::string arg { "Hello world!" };
@@ -115,11 +119,11 @@ BOOST_AUTO_TEST_CASE(String) {
     data.put(arg);
 
     BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + arg.size() + 2);
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
 }
 
 BOOST_AUTO_TEST_CASE(StringUTF8) {
-    const DataBuffer expected_buffer {
+    const std::vector<byte> expected_bytes {
         0, 0, 0, 6, 'L', 0xc3, 0xa9, 'l', 'i', 'o'
     };
     const std::string arg { "Lélio" };
@@ -128,41 +132,100 @@ BOOST_AUTO_TEST_CASE(StringUTF8) {
     data.put(arg);
 
     BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + arg.size() + 2);
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(LongString) {
+    const std::string long_str(MAX_LENGTH, ' '); // Syntaxe C++14 pour éviter l'initializer_list constructor
+
+    Data data;
+    data.put(long_str);
+
+    BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + 2 + MAX_LENGTH);
 }
 
 BOOST_AUTO_TEST_CASE(StringOverflow) {
-    const std::string big_str(10000, ' '); // Syntaxe C++14 pour éviter l'initializer_list constructor
+    const std::string big_str(MAX_LENGTH + 1, ' ');
 
     Data data;
-    BOOST_CHECK_THROW(data.put(big_str), BufferOverflow);
+    BOOST_CHECK_THROW(data.put(big_str), StringTooLong);
 }
 
 BOOST_AUTO_TEST_CASE(Int16) {
-    const DataBuffer expected_buffer { 0, 0, 0x89, 0xA0 };
+    const std::vector<byte> expected_bytes { 0, 0, 0x89, 0xA0 };
     const short arg { -30304 };
 
     Data data;
     data.putNumeric(arg);
 
     BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + sizeof(short));
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
 }
 
 BOOST_AUTO_TEST_CASE(UInt32) {
-    const DataBuffer expected_buffer { 0, 0, 0x00, 0x01, 0x11, 0x70 };
+    const std::vector<byte> expected_bytes { 0, 0, 0x00, 0x01, 0x11, 0x70 };
     const uint arg { 70000 };
 
     Data data;
     data.putNumeric(arg);
 
     BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + sizeof(uint));
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(SmallVarint) {
+    const std::vector<byte> expected_bytes { 0, 0, 0x7F };
+
+    Data data;
+    data.putVarint(127);
+
+    BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + 1);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(Varint) {
+    const std::vector<byte> expected_bytes { 0, 0, 0xF0, 0xA2, 0x04 };
+
+    Data data;
+    data.putVarint(70000);
+
+    BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + 3);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(MaxVarint) {
+    Data data;
+    data.putVarint(std::numeric_limits<ulong>::max());
+
+    BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + Data::MAX_VARINT_SIZE);
+    BOOST_CHECK_EQUAL(bytes(data).back(), 0x01);
+}
+
+BOOST_AUTO_TEST_CASE(SignedVarint) {
+    const std::vector<byte> expected_bytes { 0, 0, 0x00, 0x01, 0x02, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F };
+
+    Data data;
+    data.putSignedVarint(0);
+    data.putSignedVarint(-1);
+    data.putSignedVarint(1);
+    data.putSignedVarint(-2);
+    data.putSignedVarint(std::numeric_limits<int>::min());
+
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(VarintOverflow) {
+    Data data;
+    for (std::size_t i { 0 }; i < MAX_CONTENT_LENGTH - 2; i++)
+        data.add(0);
+
+    BOOST_CHECK_THROW(data.putVarint(70000), BufferOverflow);
+    BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + MAX_CONTENT_LENGTH - 2);
 }
 
 BOOST_AUTO_TEST_CASE(NumericOverflow) {
     Data data;
-    for (std::size_t i { 0 }; i < MAX_LENGTH - 3; i++)
+    for (std::size_t i { 0 }; i < MAX_CONTENT_LENGTH - 3; i++)
         data.add(0);
 
     BOOST_CHECK_THROW(data.putNumeric<int>(9999999), BufferOverflow);
@@ -173,7 +236,7 @@ BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE(PutList)
 
 BOOST_AUTO_TEST_CASE(Valid) {
-    const DataBuffer expected_buffer {
+    const std::vector<byte> expected_bytes {
         0, 0, 3, 0, 6, 'L', 0xc3, 0xa9, 'l', 'i', 'o', 0, 4, 'T', 'e', 's', 't', 0, 1, '#'
     };
     const OptionsList options { "Lélio", "Test", "#" };
@@ -181,17 +244,141 @@ BOOST_AUTO_TEST_CASE(Valid) {
     Data data;
     data.putList(options);
 
-    BOOST_CHECK_EQUAL(data.buffer(), expected_buffer);
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(BiggerThanPacket) {
+    const std::string txt(300, ' '); // Syntaxe C++14 pour éviter l'initializer_list constructor
+
+    OptionsList options;
+    options.resize(255, txt);
+
+    Data data;
+    data.putList(options);
+
+    BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + 1 + 255 * (2 + txt.length()));
 }
 
 BOOST_AUTO_TEST_CASE(Overflow) {
-    const std::string txt(100, ' '); // Syntaxe C++14 pour éviter l'initializer_list constructor
+    const std::string txt(5000, ' ');
 
     OptionsList options;
-    options.resize(13, txt);
+    options.resize(255, txt);
 
     Data data;
     BOOST_CHECK_THROW(data.putList(options), BufferOverflow);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(Storage)
+
+BOOST_AUTO_TEST_CASE(Inline) {
+    Data data;
+    for (std::size_t i { Data::LENGTH_SIZE }; i < INLINE_DATA_CAPACITY; i++)
+        data.add(static_cast<byte>(i));
+
+    BOOST_CHECK_EQUAL(data.count(), INLINE_DATA_CAPACITY);
+    BOOST_CHECK_EQUAL(data.capacity(), INLINE_DATA_CAPACITY);
+}
+
+BOOST_AUTO_TEST_CASE(Grow) {
+    std::vector<byte> expected_bytes { 0, 0 };
+
+    Data data;
+    for (std::size_t i { 0 }; i < 5000; i++) {
+        data.add(static_cast<byte>(i));
+        expected_bytes.push_back(static_cast<byte>(i));
+    }
+
+    BOOST_CHECK_GE(data.capacity(), data.count());
+    BOOST_CHECK_EQUAL(bytes(data), expected_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(CopyAndMove) {
+    const std::string long_str(200, 'x'); // Syntaxe C++14 pour éviter l'initializer_list constructor
+
+    Data small;
+    small.add(byte { 7 });
+
+    Data big;
+    big.put(long_str);
+
+    for (const Data* original : { &small, &big }) {
+        const Data copy { *original };
+        BOOST_CHECK(copy == *original);
+
+        Data moved_from { *original };
+        const Data moved { std::move(moved_from) };
+        BOOST_CHECK(moved == *original);
+
+        Data assigned;
+        assigned = copy;
+        BOOST_CHECK(assigned == *original);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(Factory)
+
+BOOST_AUTO_TEST_CASE(SharedPacket) {
+    const std::vector<byte> expected_bytes { 0, 4, 42, 0 };
+
+    struct TestFactory : DataFactory {
+        TestFactory() { data_->add(byte { 42 }); data_->add(false); }
+    } factory;
+
+    const Packet packet { factory.dataWithLength() };
+    const Packet copy { packet };
+
+    BOOST_CHECK_EQUAL(packet.count(), 4);
+    BOOST_CHECK_EQUAL(bytes(packet.data()), expected_bytes);
+    BOOST_CHECK_EQUAL(&copy.data(), &factory.data());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(Fragments)
+
+BOOST_AUTO_TEST_CASE(NotFragmented) {
+    const Packet packet { std::make_shared<const Data>(std::vector<byte>(MAX_LENGTH - Data::LENGTH_SIZE, 1)) };
+
+    BOOST_CHECK(!packet.fragmented());
+    BOOST_CHECK_EQUAL(packet.fragments(), 1);
+    BOOST_CHECK_EQUAL(packet.count(), MAX_LENGTH);
+}
+
+BOOST_AUTO_TEST_CASE(Fragmented) {
+    std::vector<byte> content(2 * Packet::MAX_FRAGMENT_CONTENT + 10);
+    for (std::size_t i { 0 }; i < content.size(); i++)
+        content[i] = static_cast<byte>(i);
+
+    auto data { std::make_shared<Data>(content) };
+    data->refreshLength();
+    const Packet packet { data };
+
+    BOOST_CHECK(packet.fragmented());
+    BOOST_CHECK_EQUAL(packet.fragments(), 3);
+    BOOST_CHECK_EQUAL(packet.count(), content.size() + 3 * Packet::FRAGMENT_HEADER_SIZE);
+    BOOST_CHECK_EQUAL(readBigEndian<word>(packet.data().buffer()), 0);
+
+    std::vector<byte> reassembled;
+    for (std::size_t i { 0 }; i < packet.fragments(); i++) {
+        const Packet::Fragment fragment { packet.fragment(i) };
+        const std::vector<byte> expected_header {
+            static_cast<byte>((Packet::FRAGMENT_HEADER_SIZE + fragment.content_length) >> 8),
+            static_cast<byte>(Packet::FRAGMENT_HEADER_SIZE + fragment.content_length),
+            FRAGMENT_EVENT, 0, static_cast<byte>(i), 0, 3
+        };
+
+        BOOST_CHECK_EQUAL(std::vector<byte>(fragment.header, fragment.header + Packet::FRAGMENT_HEADER_SIZE), expected_header);
+        reassembled.insert(reassembled.end(), fragment.content, fragment.content + fragment.content_length);
+    }
+
+    BOOST_CHECK_EQUAL(packet.fragment(0).content_length, Packet::MAX_FRAGMENT_CONTENT);
+    BOOST_CHECK_EQUAL(packet.fragment(2).content_length, 10);
+    BOOST_CHECK_EQUAL(reassembled, content);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,85 @@
+#define BOOST_TEST_MODULE Schema
+
+#include <boost/test/unit_test.hpp>
+#include <Rbo/SessionDataFactory.hpp>
+
+using namespace Rbo;
+
+using Options = SessionSchema::Options;
+using BinaryBattleAtk = SessionSchema::BinaryBattleAtk;
+
+BOOST_AUTO_TEST_SUITE(Encode)
+
+BOOST_AUTO_TEST_CASE(ExactSize) {
+    const OptionsList options { "Zero", "One", "Two" };
+
+    Data data;
+    Options::encode(data, ALL_PLAYERS, "Choix", options);
+
+    BOOST_CHECK_EQUAL(data.count(), Data::LENGTH_SIZE + Options::size(ALL_PLAYERS, "Choix", options));
+    BOOST_CHECK_EQUAL(BinaryBattleAtk::size(0, 1, -300), 2 + 1 + 1 + 2);
+}
+
+BOOST_AUTO_TEST_CASE(SameAsFactory) {
+    SessionDataFactory factory;
+    factory.makeRange(ALL_PLAYERS, "How are you?", 5, 15);
+
+    Data data;
+    SessionSchema::Range::encode(data, ALL_PLAYERS, "How are you?", 5, 15);
+
+    BOOST_CHECK(data == factory.data());
+}
+
+BOOST_AUTO_TEST_CASE(CountTooLarge) {
+    Data data;
+    BOOST_CHECK_THROW(Schema::Bytes::encode(data, std::vector<byte>(256, 0)), ListTooLong);
+    BOOST_CHECK_THROW(Options::encode(data, ALL_PLAYERS, "Choix", OptionsList(256, "Option")), ListTooLong);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(Decode)
+
+BOOST_AUTO_TEST_CASE(RoundTrip) {
+    const OptionsList options { "Zero", "One", "Lélio" };
+
+    SessionDataFactory factory;
+    factory.makeOptions(3, "Choix", options);
+
+    DataReader reader { factory.data() };
+    const auto [target, msg, decoded_options] { Options::decode(reader) };
+
+    BOOST_CHECK_EQUAL(target, 3);
+    BOOST_CHECK_EQUAL(msg, "Choix");
+    BOOST_CHECK(decoded_options == options);
+    BOOST_CHECK_EQUAL(reader.remaining(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Varints) {
+    Data data;
+    BinaryBattleAtk::encode(data, 2, 70000, std::numeric_limits<int>::min());
+
+    DataReader reader { data };
+    const auto [player, enemy, dmg] { BinaryBattleAtk::decode(reader) };
+
+    BOOST_CHECK_EQUAL(player, 2);
+    BOOST_CHECK_EQUAL(enemy, 70000);
+    BOOST_CHECK_EQUAL(dmg, std::numeric_limits<int>::min());
+}
+
+BOOST_AUTO_TEST_CASE(UnexpectedHeader) {
+    SessionDataFactory factory;
+    factory.makeCrash(1);
+
+    DataReader reader { factory.data() };
+    BOOST_CHECK_THROW(SessionSchema::LeaderSwitch::decode(reader), Schema::UnexpectedHeader);
+}
+
+BOOST_AUTO_TEST_CASE(Truncated) {
+    const std::vector<byte> truncated { static_cast<byte>(Event::Start), 0, 10, 'A' };
+
+    DataReader reader { truncated.data(), truncated.size() };
+    BOOST_CHECK_THROW(SessionSchema::Start::decode(reader), MalformedData);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
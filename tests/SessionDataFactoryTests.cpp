@@ -3,6 +3,7 @@
 #include <iomanip>
 #include <boost/test/unit_test.hpp>
 #include <nlohmann/json.hpp>
+#include <Rbo/Dictionary.hpp>
 #include <Rbo/Game.hpp>
 #include <Rbo/SessionDataFactory.hpp>
 
@@ -15,7 +16,7 @@ namespace Rbo {
 std::ostream& operator<<(std::ostream& out, const Data& data) {
     out << "Data (" << data.count() << " B) :" << std::hex << std::setw(4) << std::showbase << std::internal << std::setfill('0');
 
-    const auto begin { data.buffer().cbegin() };
+    const byte* begin { data.buffer() };
     for (const byte b : std::vector<byte> { begin, begin + data.count() })
         out << ' ' << int { b };
 
@@ -24,6 +25,22 @@ std::ostream& operator<<(std::ostream& out, const Data& data) {
 
 } // namespace Rbo
 
+Game dictionaryGame() {
+    Game ctx;
+    ctx.globalStats = { { "day", {} } };
+    ctx.playerStats = { { "c", {} }, { "a", {} }, { "b", {} } };
+    ctx.playerInventories = {
+        { "inv2", InventoryDescriptor { {}, { "A" }, {} } },
+        { "inv1", InventoryDescriptor { {}, { "B", "A" }, {} } }
+    };
+    ctx.enemies = {
+        { "Orc", { 10, 3 } },
+        { "Goblin", { 70, -1 } }
+    };
+
+    return ctx;
+}
+
 BOOST_AUTO_TEST_SUITE(Make)
 
 BOOST_AUTO_TEST_CASE(Range) {
@@ -61,6 +78,18 @@ BOOST_AUTO_TEST_CASE(MoreThan256Options) {
     BOOST_CHECK_THROW(factory.makeOptions(0, "Choix", arg), TooManyOptions);
 }
 
+BOOST_AUTO_TEST_CASE(OptionsLimit) {
+    SessionDataFactory factory;
+    factory.makeOptions(0, "Choix", OptionsList(OPTIONS_LIMIT, "Option"));
+
+    DataReader reader { factory.data() };
+    const auto [target, msg, options] { SessionSchema::Options::decode(reader) };
+    BOOST_CHECK_EQUAL(options.size(), 255);
+
+    SessionDataFactory too_many;
+    BOOST_CHECK_THROW(too_many.makeOptions(0, "Choix", OptionsList(256, "Option")), TooManyOptions);
+}
+
 BOOST_AUTO_TEST_CASE(DiceRoll) {
     const Data expected {
         std::vector<byte> {
@@ -127,6 +156,107 @@ BOOST_AUTO_TEST_CASE(PlayerUpdates) {
     BOOST_CHECK_EQUAL(expected, factory.data());
 }
 
+BOOST_AUTO_TEST_CASE(SymbolsDictionary) {
+    const Data expected {
+        std::vector<byte> {
+            14,
+            1, 0, 3, 'd', 'a', 'y',
+            3, 0, 1, 'a', 0, 1, 'b', 0, 1, 'c',
+            2, 0, 4, 'i', 'n', 'v', '1', 2, 0, 1, 'A', 0, 1, 'B',
+            0, 4, 'i', 'n', 'v', '2', 1, 0, 1, 'A',
+            2, 0, 6, 'G', 'o', 'b', 'l', 'i', 'n', 0, 3, 'O', 'r', 'c'
+        }
+    };
+
+    SessionDataFactory factory;
+    factory.makeDictionary(Dictionary { dictionaryGame() });
+
+    BOOST_CHECK_EQUAL(expected, factory.data());
+}
+
+BOOST_AUTO_TEST_CASE(BinaryPlayerUpdates) {
+    const Data expected {
+        std::vector<byte> {
+            2, 4, 0b1110,
+            3, 0, 0b01, 1, 0b10, 4, 2, 0b11,
+            2, 0, 2, 0, 10, 1, 7, 1, 1, 0, 1,
+            2, 0, 0, 1, 56
+        }
+    };
+
+    const PlayerUpdate changes {
+        Death {},
+        {
+            { "a", Stat { 1, StatLimits {}, true, false } },
+            { "b", Stat { 2, StatLimits {}, false, true } },
+            { "c", Stat { 3, StatLimits {}, true, true } }
+        },
+        {
+            { "inv1", { { "A", 5 }, { "B", -4 } } },
+            { "inv2", { { "A", -1 } } }
+        },
+        { { "inv1", {} }, { "inv2", 55 } }
+    };
+
+    SessionDataFactory factory;
+    factory.makePlayerUpdate(4, changes, Dictionary { dictionaryGame() });
+
+    BOOST_CHECK_EQUAL(expected, factory.data());
+}
+
+BOOST_AUTO_TEST_CASE(BinaryDeathAndLimits) {
+    const Data expected {
+        std::vector<byte> {
+            2, 1, 0b11, 0, 4, 'D', 'e', 'a', 'd',
+            1, 1, 0b1100, 5, 0, 20
+        }
+    };
+
+    const PlayerUpdate changes {
+        Death { "Dead" }, { { "b", Stat { -3, StatLimits { 0, 10 }, false, false } } }, {}, {}
+    };
+
+    SessionDataFactory factory;
+    factory.makePlayerUpdate(1, changes, Dictionary { dictionaryGame() });
+
+    BOOST_CHECK_EQUAL(expected, factory.data());
+}
+
+BOOST_AUTO_TEST_CASE(BinaryUnknownStat) {
+    const PlayerUpdate changes { Death {}, { { "z", Stat {} } }, {}, {} };
+
+    SessionDataFactory factory;
+    BOOST_CHECK_THROW(factory.makePlayerUpdate(1, changes, Dictionary { dictionaryGame() }), UnknownSymbol);
+}
+
+BOOST_AUTO_TEST_CASE(BinaryBattle) {
+    const Data expected_init {
+        std::vector<byte> {
+            8, 0, 2, 0, 1, 'B', 1, 20, 6, 0, 1, 'A', 0, 0x8C, 0x01, 1
+        }
+    };
+    const Data expected_atk { std::vector<byte> { 8, 1, 3, 1, 9 } };
+
+    const Game ctx { dictionaryGame() };
+    const Dictionary dictionary { ctx };
+    const GroupDescriptor group {
+        EnemyDescriptorBinding { "B", "Orc" },
+        EnemyDescriptorBinding { "A", "Goblin" }
+    };
+
+    SessionDataFactory init_factory;
+    init_factory.makeBattleInit(group, ctx, dictionary);
+
+    SessionDataFactory atk_factory;
+    atk_factory.makeBattleAtk(3, "A", -5, group);
+
+    BOOST_CHECK_EQUAL(expected_init, init_factory.data());
+    BOOST_CHECK_EQUAL(expected_atk, atk_factory.data());
+
+    SessionDataFactory unknown_factory;
+    BOOST_CHECK_THROW(unknown_factory.makeBattleAtk(3, "C", -5, group), UnknownSymbol);
+}
+
 BOOST_AUTO_TEST_CASE(BattleInit) {
     Data expected { std::vector<byte> { 8, 0 } };
     const json group_data = json::array({
@@ -193,6 +323,19 @@ BOOST_AUTO_TEST_CASE(HiddenNotMain) {
     BOOST_CHECK_EQUAL(expected, factory.data());
 }
 
+BOOST_AUTO_TEST_CASE(Binary) {
+    const Data expected {
+        std::vector<byte> {
+            3, 0, 0b1110, 0, 0xA8, 0x07, 0xC8, 0x1F
+        }
+    };
+
+    SessionDataFactory factory;
+    factory.makeGlobalStat("day", Stat { 0, { 468, 2020 }, false, true }, Dictionary { dictionaryGame() });
+
+    BOOST_CHECK_EQUAL(expected, factory.data());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()